@@ -139,6 +139,9 @@ class SQUADConverter():
                 sample_dict['input_mask'] = input_mask
                 sample_dict['segment_ids'] = segment_ids
                 sample_dict['tokens'] = tokens
+                # Lets the harness score SQuAD F1 per example without the original json
+                sample_dict['example_index'] = example_index
+                sample_dict['answers'] = [answer['text'] for answer in answers[example_index]]
                 all_samples.append(sample_dict)
         return all_samples
 
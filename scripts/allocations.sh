@@ -0,0 +1,44 @@
+#!/bin/bash
+# Runs every scenario of a model in Performance mode with a harness built with
+# -DENABLE_ALLOCATION_COUNTER=ON and checks that no query allocated on the heap.
+# Build it next to the regular binary, e.g. from ${BUILD_DIRECTORY}/src:
+#   cmake -DENABLE_ALLOCATION_COUNTER=ON -DBIN_FOLDER=allocations ... && make
+BASEDIR=$(dirname "$0")
+
+while getopts m:d:b: flag
+do
+    case "${flag}" in
+        m) MODELNAME=${OPTARG};;
+        d) DEVICE=${OPTARG};;
+        b) ALLOC_BIN=${OPTARG};;
+    esac
+done
+
+if [[ -z ${MODELNAME} ]] || [[ -z ${DEVICE} ]]; then
+    echo "Usage: allocations.sh -m <model> -d <device> [-b <ov_mlperf built with the allocation counter>]"
+    exit
+fi
+
+export OV_MLPERF_BIN=${ALLOC_BIN:-${BUILD_DIRECTORY}/src/Release_allocations/ov_mlperf}
+SCENARIOS=( "SingleStream" "MultiStream" "Offline" "Server" )
+FAILED=0
+
+for SCENARIO in "${SCENARIOS[@]}"
+do
+    ${BASEDIR}/run.sh -e Performance -m ${MODELNAME} -d ${DEVICE} -s ${SCENARIO}
+
+    LOG=${RESULTS_DIR}/${MODELNAME}/${DEVICE}/Performance/${SCENARIO}/ov_mlperf_log.txt
+    # "    [INFO] Harness heap allocations: <allocations> in <queries> queries (<n> per query)"
+    LINE=$(grep "Harness heap allocations" ${LOG})
+    if [[ -z ${LINE} ]]; then
+        echo "${SCENARIO}: no allocation report, was ${OV_MLPERF_BIN} built with the counter?"
+        FAILED=1
+    elif [[ $(echo ${LINE} | awk '{print $5}') != "0" ]]; then
+        echo "${SCENARIO}: ${LINE}"
+        FAILED=1
+    else
+        echo "${SCENARIO}: zero allocations ($(echo ${LINE} | awk '{print $7}') queries)"
+    fi
+done
+
+exit ${FAILED}
@@ -36,8 +36,8 @@ mkdirs ${OUT_DIR}
 
 ACC_FILENAME=${OUT_DIR}/mlperf_log_accuracy.json
 
-# By default C++ launcher is used
-OV_MLPERF_BIN=${BUILD_DIRECTORY}/src/Release/ov_mlperf
+# By default C++ launcher is used; OV_MLPERF_BIN selects another build of it
+OV_MLPERF_BIN=${OV_MLPERF_BIN:-${BUILD_DIRECTORY}/src/Release/ov_mlperf}
 
 case "${MODELNAME}" in
 "resnet50")
@@ -115,6 +115,11 @@ if [ ${DEVICE} == "GPU" ]; then
     OV_MLPERF_ARGS="${OV_MLPERF_ARGS} --infer_precision f16"
 fi
 
+# Reuse compiled models across runs
+if [ ! -z ${MODEL_CACHE_DIR} ]; then
+    OV_MLPERF_ARGS="${OV_MLPERF_ARGS} --model_cache_dir ${MODEL_CACHE_DIR}"
+fi
+
 # Running benchmark
 OV_MLPERF_FULL_CMD="${OV_MLPERF_BIN} ${OV_MLPERF_ARGS}"
 echo "Running benchmark: ${OV_MLPERF_FULL_CMD}"
@@ -27,3 +27,4 @@ export OPENVINO_DIR=${OPENVINO_DIR}
 export MODEL_DIR=${BUILD_DIRECTORY}/models
 export DATASET_DIR=${BUILD_DIRECTORY}/datasets
 export RESULTS_DIR=${BUILD_DIRECTORY}/results
+export MODEL_CACHE_DIR=${BUILD_DIRECTORY}/model_cache
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+/// @brief Opt-in heap allocation counter for the harness hot path.
+///
+/// Built with -DENABLE_ALLOCATION_COUNTER=ON, global operator new counts every
+/// allocation made by a thread inside an ALLOCATION_SCOPE (IssueQuery, server
+/// dispatch and completion post-processing). Calls back into loadgen are
+/// excluded with ALLOCATION_SCOPE_PAUSE. report() prints allocations per issued
+/// query after the run; scripts/allocations.sh checks that it stays at zero.
+/// Without the option the scope macros expand to nothing.
+namespace alloc_counter {
+#ifdef ENABLE_ALLOCATION_COUNTER
+static thread_local int scope_depth = 0;
+static std::atomic<uint64_t> num_allocations{0};
+static std::atomic<uint64_t> num_queries{0};
+
+struct Scope {
+    Scope() { ++scope_depth; }
+    ~Scope() { --scope_depth; }
+};
+
+struct Pause {
+    Pause() : saved_depth(scope_depth) { scope_depth = 0; }
+    ~Pause() { scope_depth = saved_depth; }
+    int saved_depth;
+};
+
+inline void count_query() {
+    num_queries.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void report() {
+    uint64_t allocations = num_allocations.load();
+    uint64_t queries = num_queries.load();
+    std::cout << "    [INFO] Harness heap allocations: " << allocations << " in " << queries << " queries ("
+              << (queries ? static_cast<double>(allocations) / queries : 0.0) << " per query)" << std::endl;
+    if (allocations > 0) {
+        std::cout << "    [WARNING] The harness hot path allocated on the heap" << std::endl;
+    }
+}
+#else
+inline void count_query() {}
+inline void report() {}
+#endif
+} // namespace alloc_counter
+
+#ifdef ENABLE_ALLOCATION_COUNTER
+#define ALLOCATION_SCOPE() alloc_counter::Scope alloc_scope_guard_
+#define ALLOCATION_SCOPE_PAUSE() alloc_counter::Pause alloc_pause_guard_
+#else
+#define ALLOCATION_SCOPE()
+#define ALLOCATION_SCOPE_PAUSE()
+#endif
+
+#ifdef ENABLE_ALLOCATION_COUNTER
+void* operator new(std::size_t size) {
+    if (alloc_counter::scope_depth > 0) {
+        alloc_counter::num_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+#endif
@@ -0,0 +1,320 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+// loadgen
+#include "loadgen.h"
+#include "test_settings.h"
+
+/// @brief One point of the AutoTune search space.
+struct TuneConfig {
+    std::string nstreams = "";
+    int nthreads = 0;
+    uint32_t nireq = 0;
+    unsigned batch_size = 1;
+    // Empty keeps the --infer_precision of the run
+    std::string infer_precision = "";
+
+    std::string to_flags() const {
+        std::stringstream flags;
+        if (!nstreams.empty()) {
+            flags << "--nstreams " << nstreams << " ";
+        }
+        flags << "--nthreads " << nthreads << " --nireq " << nireq << " --batch_size " << batch_size;
+        if (!infer_precision.empty()) {
+            flags << " --infer_precision " << infer_precision;
+        }
+        return flags.str();
+    }
+};
+
+/// @brief Metrics read back from a trial's mlperf_log_summary.txt.
+struct TrialSummary {
+    bool found = false;
+    // Only scenarios with a latency constraint print "Performance constraints satisfied"
+    bool has_constraints_line = false;
+    bool constraints_satisfied = false;
+    // "Min duration satisfied" / "Min queries satisfied"
+    bool min_duration_satisfied = false;
+    bool min_queries_satisfied = false;
+    double samples_per_second = 0;
+    double completed_samples_per_second = 0;
+    double latency_p90_ns = 0;
+    double latency_p99_ns = 0;
+
+    // Trials shorten min_duration but keep offline_expected_qps, so loadgen sizes the Offline
+    // query for the configured target and any faster configuration finishes early and is
+    // reported INVALID. Only the latency constraint decides a trial; duration, query count
+    // and early-stopping misses follow from the short run.
+    bool valid() const {
+        return found && (!has_constraints_line || constraints_satisfied);
+    }
+
+    // Shortened by the trial settings, not by a constraint; the rate is still measured
+    bool short_run() const {
+        return found && (!min_duration_satisfied || !min_queries_satisfied);
+    }
+};
+
+std::vector<std::string> split_list(const std::string& list) {
+    std::vector<std::string> values;
+    std::stringstream ss(list);
+    std::string value;
+    while (std::getline(ss, value, ',')) {
+        if (!value.empty()) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+TrialSummary parse_summary(const std::string& path) {
+    TrialSummary summary;
+    std::ifstream file(path);
+    std::string line;
+    auto value_of = [](const std::string& line) {
+        return std::stod(line.substr(line.rfind(':') + 1));
+    };
+    while (std::getline(file, line)) {
+        summary.found = true;
+        if (line.find("Performance constraints satisfied") != std::string::npos) {
+            summary.has_constraints_line = true;
+            summary.constraints_satisfied = line.find("Yes") != std::string::npos;
+        } else if (line.find("Min duration satisfied") != std::string::npos) {
+            summary.min_duration_satisfied = line.find("Yes") != std::string::npos;
+        } else if (line.find("Min queries satisfied") != std::string::npos) {
+            summary.min_queries_satisfied = line.find("Yes") != std::string::npos;
+        } else if (line.find("Completed samples per second") != std::string::npos) {
+            summary.completed_samples_per_second = value_of(line);
+        } else if (line.find("Samples per second") != std::string::npos) {
+            summary.samples_per_second = value_of(line);
+        } else if (line.find("90.00 percentile latency (ns)") != std::string::npos) {
+            summary.latency_p90_ns = value_of(line);
+        } else if (line.find("99.00 percentile latency (ns)") != std::string::npos) {
+            summary.latency_p99_ns = value_of(line);
+        }
+    }
+    return summary;
+}
+
+/// @brief Sweeps harness and OpenVINO parameters with short performance runs.
+///
+/// Every configuration is run through the caller's trial function against the
+/// real QSL and backend with a shortened duration. Trials are ranked by the
+/// scenario's metric: Offline samples/s, Server highest target QPS that still
+/// meets the latency constraint, SingleStream 90th and MultiStream 99th
+/// percentile latency. The winner is written as a user.conf fragment and a
+/// line of harness flags to the log directory.
+class AutoTuner final {
+public:
+    using TrialFunction = std::function<void(const TuneConfig&, const mlperf::TestSettings&,
+                                             const mlperf::LogSettings&)>;
+
+    AutoTuner(const mlperf::TestSettings& settings,
+              const mlperf::LogSettings& log_settings,
+              const std::string& model_name,
+              const std::string& scenario_name,
+              uint32_t duration_ms,
+              uint32_t qps_steps,
+              const std::string& output_name = "autotune") :
+            settings_(settings),
+            log_settings_(log_settings),
+            model_name_(model_name),
+            scenario_name_(scenario_name),
+            qps_steps_(qps_steps) {
+        output_dir_ = log_settings_.log_output.outdir.empty() ? output_name
+                : (boost::filesystem::path(log_settings_.log_output.outdir) / output_name).string();
+        settings_.mode = mlperf::TestMode::PerformanceOnly;
+        settings_.min_duration_ms = duration_ms;
+        settings_.max_duration_ms = 4 * static_cast<uint64_t>(duration_ms);
+        settings_.min_query_count = 1;
+    }
+
+    /// Cartesian product of the given lists; empty lists fall back to scenario defaults.
+    std::vector<TuneConfig> search_space(const std::string& nstreams_list,
+                                         const std::string& nthreads_list,
+                                         const std::string& nireq_list,
+                                         const std::string& batch_size_list) const {
+        bool single_stream = settings_.scenario == mlperf::TestScenario::SingleStream;
+        std::vector<std::string> nstreams = split_list(nstreams_list);
+        if (nstreams.empty()) {
+            if (single_stream) {
+                nstreams = {"1"};
+            } else {
+                unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+                for (unsigned n : {1u, 2u, 4u, cores / 4, cores / 2}) {
+                    if (n > 0 && std::find(nstreams.begin(), nstreams.end(), std::to_string(n)) == nstreams.end()) {
+                        nstreams.push_back(std::to_string(n));
+                    }
+                }
+            }
+        }
+        std::vector<std::string> batch_sizes = split_list(batch_size_list);
+        if (batch_sizes.empty()) {
+            batch_sizes = single_stream ? std::vector<std::string>{"1"} : std::vector<std::string>{"1", "2", "4", "8"};
+        }
+
+        std::vector<TuneConfig> configs;
+        for (const auto& streams : nstreams) {
+            for (const auto& threads : split_list(nthreads_list)) {
+                for (const auto& nireq : split_list(nireq_list)) {
+                    for (const auto& batch : batch_sizes) {
+                        TuneConfig config;
+                        config.nstreams = streams;
+                        config.nthreads = std::stoi(threads);
+                        config.nireq = std::stoul(nireq);
+                        config.batch_size = std::stoul(batch);
+                        configs.push_back(config);
+                    }
+                }
+            }
+        }
+        return configs;
+    }
+
+    void run(const std::vector<TuneConfig>& configs, const TrialFunction& run_trial) {
+        std::cout << "    [INFO] AutoTune: " << configs.size() << " configuration(s), "
+                  << settings_.min_duration_ms << " ms per trial" << std::endl;
+        bool have_best = false;
+        TuneConfig best;
+        double best_score = 0;
+        double best_value = 0;
+
+        for (const auto& config : configs) {
+            bool valid = false;
+            double value = measure(config, run_trial, valid);
+
+            // Throughput is maximized, latency minimized
+            double score = lower_is_better() ? -value : value;
+            if (valid && value > 0 && (!have_best || score > best_score)) {
+                have_best = true;
+                best = config;
+                best_score = score;
+                best_value = value;
+            }
+        }
+
+        if (!have_best) {
+            std::cout << "    [WARNING] AutoTune: no configuration met the scenario constraints" << std::endl;
+            return;
+        }
+        write_results(best, best_value);
+    }
+
+    /// Runs one configuration and returns its scenario metric; valid is set when the constraints held.
+    double measure(const TuneConfig& config, const TrialFunction& run_trial, bool& valid) {
+        double value = 0;
+        bool short_run = false;
+        valid = false;
+        try {
+            if (settings_.scenario == mlperf::TestScenario::Server) {
+                valid = run_server(config, run_trial, value);
+            } else {
+                TrialSummary summary = run_one(config, settings_, run_trial);
+                valid = summary.valid();
+                value = metric(summary);
+                short_run = summary.short_run();
+            }
+        } catch (const std::exception& e) {
+            std::cout << "    [WARNING] AutoTune: " << config.to_flags() << " failed: " << e.what() << std::endl;
+        }
+        std::cout << "    [INFO] AutoTune: " << config.to_flags() << " -> " << value << " " << metric_name()
+                  << (valid ? "" : " (constraints not met)")
+                  << (valid && short_run ? " (ended before min duration, not counted against it)" : "") << std::endl;
+        return value;
+    }
+
+    std::string metric_name() const {
+        switch (settings_.scenario) {
+            case mlperf::TestScenario::SingleStream:
+                return "ms p90 latency";
+            case mlperf::TestScenario::MultiStream:
+                return "ms p99 latency";
+            case mlperf::TestScenario::Server:
+                return "target QPS";
+            default:
+                return "samples/s";
+        }
+    }
+
+private:
+    TrialSummary run_one(const TuneConfig& config, const mlperf::TestSettings& settings,
+                         const TrialFunction& run_trial) {
+        mlperf::LogSettings log_settings = log_settings_;
+        log_settings.log_output.outdir = (boost::filesystem::path(output_dir_) /
+                                          ("trial_" + std::to_string(num_trials_++))).string();
+        boost::filesystem::create_directories(log_settings.log_output.outdir);
+
+        run_trial(config, settings, log_settings);
+        return parse_summary((boost::filesystem::path(log_settings.log_output.outdir) /
+                              (log_settings.log_output.prefix + "summary" + log_settings.log_output.suffix + ".txt")).string());
+    }
+
+    // Raises the target QPS by 10% per step while the latency constraint holds
+    bool run_server(const TuneConfig& config, const TrialFunction& run_trial, double& best_qps) {
+        mlperf::TestSettings settings = settings_;
+        bool valid = false;
+        for (uint32_t step = 0; step <= qps_steps_; ++step) {
+            TrialSummary summary = run_one(config, settings, run_trial);
+            if (!summary.valid()) {
+                break;
+            }
+            valid = true;
+            best_qps = settings.server_target_qps;
+            settings.server_target_qps *= 1.1;
+        }
+        return valid;
+    }
+
+    double metric(const TrialSummary& summary) const {
+        switch (settings_.scenario) {
+            case mlperf::TestScenario::SingleStream:
+                return summary.latency_p90_ns / 1e6;
+            case mlperf::TestScenario::MultiStream:
+                return summary.latency_p99_ns / 1e6;
+            default:
+                return summary.samples_per_second;
+        }
+    }
+
+    bool lower_is_better() const {
+        return settings_.scenario == mlperf::TestScenario::SingleStream ||
+               settings_.scenario == mlperf::TestScenario::MultiStream;
+    }
+
+    void write_results(const TuneConfig& best, double value) const {
+        std::string conf_path = (boost::filesystem::path(output_dir_) / "user.conf").string();
+        std::string flags_path = (boost::filesystem::path(output_dir_) / "harness_flags.txt").string();
+        std::string key = model_name_ + "." + scenario_name_ + ".";
+
+        std::ofstream conf(conf_path);
+        conf << "# Generated by ov_mlperf --mode AutoTune (" << best.to_flags() << ")" << std::endl;
+        if (lower_is_better()) {
+            conf << key << "target_latency = " << std::fixed << std::setprecision(3) << value << std::endl;
+        } else {
+            conf << key << "target_qps = " << std::fixed << std::setprecision(1) << value << std::endl;
+        }
+        std::ofstream(flags_path) << best.to_flags() << std::endl;
+
+        std::cout << "    [INFO] AutoTune best: " << best.to_flags() << " -> " << value << " " << metric_name() << std::endl;
+        std::cout << "    [INFO] AutoTune wrote " << conf_path << " and " << flags_path << std::endl;
+    }
+
+    mlperf::TestSettings settings_;
+    mlperf::LogSettings log_settings_;
+    std::string model_name_;
+    std::string scenario_name_;
+    std::string output_dir_;
+    uint32_t qps_steps_;
+    size_t num_trials_ = 0;
+};
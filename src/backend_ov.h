@@ -2,45 +2,82 @@
 #define BACKENDOV_H__
 
 #include <openvino/openvino.hpp>
+#include <openvino/opsets/opset11.hpp>
+#include <array>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <sstream>
 #include <vector>
 
 #include "infer_request_wrap.h"
 #include "item_ov.h"
+#include "model_cache.h"
+#include "numa.h"
+#include "response_arena.h"
 #include "utils.h"
+#include "workload_helpers.h"
 
 struct OVBackendProperties {
     std::string device = "CPU";
     std::string nstreams = "";
     std::string infer_precision = "";
     int nthreads = 0;
-    uint32_t nireq = 1;
+    // 0 uses the device's optimal number of infer requests
+    uint32_t nireq = 0;
+    // Server: bounds of an elastic request pool, which starts at nireq; nireq_max 0 keeps it fixed
+    uint32_t nireq_min = 1;
+    uint32_t nireq_max = 0;
     bool allow_auto_batching = false;
     std::string extensions = "";
+    // Post-processing worker threads; 0 runs post-processing in the OpenVINO callback
+    unsigned pp_threads = 0;
+    std::string pp_cores = "";
+    // Directory of exported compiled models; empty disables the cache
+    std::string cache_dir = "";
+    // Side of the NHWC BGR images the QSL stores when the graph does image preprocessing; 0 disables it
+    size_t graph_preprocess_size = 0;
+    // Replace the classifier's scores output with its top-1 index computed in the graph
+    bool ingraph_topk = false;
+    // Copy queries into request-owned input tensors instead of calling set_tensor() per query
+    bool prebind_inputs = false;
+    // Bind each request's response output to harness memory in loadgen's response layout
+    // and complete queries straight from it (workloads with a response_output_name)
+    bool zero_copy_outputs = false;
+    // Sorted sequence-length buckets ending at the maximum length; empty keeps static shapes
+    std::vector<size_t> seq_buckets;
+    // Compile the batch dimension as [1, batch size] so partial batches run unpadded
+    bool dynamic_batch = false;
+    // Read IR weights through a read-only memory map, so backends and processes using the
+    // same .bin share its page-cache pages
+    bool mmap_weights = true;
+    // Cores of each backend instance, typically one NUMA node each; empty runs one instance
+    std::vector<std::vector<int>> instance_cores;
+    // Cores of this instance, taken from instance_cores by the SUT; empty leaves placement to the plugin
+    std::vector<int> cores;
 };
 
+template <typename Workload>
 class OVBackendBase {
  public:
+  using RequestsQueue = InferRequestsQueue<Workload>;
+  using RequestsQueueServer = InferRequestsQueueServer<Workload>;
+
   OVBackendBase(mlperf::TestSettings settings,
                 OVBackendProperties ov_properties,
                 unsigned batch_size,
-                std::string workload,
-                std::vector<std::string> input_blob_names,
-                std::vector<std::string> output_blob_names,
-                std::string input_model,
-                PPFunction post_processor)
+                std::string input_model)
       : settings_(settings),
         batch_size_(batch_size),
         ov_properties_(ov_properties),
-        workload_(workload),
-        input_blob_names_(input_blob_names),
-        output_blob_names_(output_blob_names),
         input_model_(input_model),
-        post_processor_(post_processor),
         inferRequestsQueue_(),
         inferRequestsQueueServer_(),
         object_size_() {}
 
-    ~OVBackendBase() {}
+    ~OVBackendBase() = default;
 
     std::string version() { return ""; }
 
@@ -50,29 +87,55 @@ class OVBackendBase {
 
     void set_infer_request() {
         inferRequest_ = compiled_model_.create_infer_request();
+        if (ov_properties_.zero_copy_outputs) {
+            bind_response_output<Workload>(inferRequest_, compiled_model_, response_output_);
+        }
     }
 
     void create_requests() {
-        inferRequestsQueue_ = new InferRequestsQueue(
-            compiled_model_, ov_properties_.nireq, input_blob_names_, output_blob_names_,
-            settings_, workload_, batch_size_, post_processor_);
+        inferRequestsQueue_.reset(new RequestsQueue(
+            compiled_model_, ov_properties_.nireq, settings_, batch_size_, max_response_size_,
+            ov_properties_.pp_threads, ov_properties_.pp_cores, ov_properties_.prebind_inputs,
+            ov_properties_.zero_copy_outputs));
     }
 
     void create_server_requests() {
-        inferRequestsQueueServer_ = new InferRequestsQueueServer(
-            compiled_model_, ov_properties_.nireq, input_blob_names_, output_blob_names_,
-            settings_, workload_, batch_size_, post_processor_);
+        inferRequestsQueueServer_.reset(new RequestsQueueServer(
+            compiled_model_, ov_properties_.nireq, settings_, batch_size_, max_response_size_,
+            ov_properties_.pp_threads, ov_properties_.pp_cores, ov_properties_.prebind_inputs,
+            ov_properties_.zero_copy_outputs));
+    }
+
+    // Response storage sized for one batch of this model's outputs
+    void init_response_arena(ResponseArena& arena) {
+        // Zero-copy responses point into the request's bound output instead
+        arena.set_zero_copy(ov_properties_.zero_copy_outputs);
+        arena.reserve(ov_properties_.zero_copy_outputs ? 0 : max_response_size_, batch_size_);
     }
 
-    void warmup(Item input) {
-        for (size_t j = 0; j < input_blob_names_.size(); j++) {
-            inferRequest_.set_tensor(input_blob_names_[j], input.tensors_[j]);
+    void warmup(const Item &input) {
+        for (size_t j = 0; j < Workload::num_inputs; j++) {
+            inferRequest_.set_tensor(input_ports_[j], input.tensors_[j]);
         }
         inferRequest_.infer();
-        std::vector<float> results;
-        std::vector<mlperf::ResponseId> response_ids;
-        std::vector<unsigned> counts;
-        post_processor_(input, inferRequest_, results, response_ids, 1, counts);
+        warmup_arena_.clear();
+        Workload::postprocess(input, inferRequest_, output_ports_, warmup_arena_, 1);
+    }
+
+    // Median latency of one Item on a dedicated synchronous request, in ms
+    double time_infer(const Item &input, size_t iters) {
+        ov::InferRequest request = compiled_model_.create_infer_request();
+        for (size_t j = 0; j < Workload::num_inputs; j++) {
+            request.set_tensor(input_ports_[j], input.tensors_[j]);
+        }
+        std::vector<double> times;
+        for (size_t i = 0; i < std::max<size_t>(iters, 1); ++i) {
+            auto start = std::chrono::steady_clock::now();
+            request.infer();
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+        return times[times.size() / 2];
     }
 
     void reset() {
@@ -90,8 +153,8 @@ class OVBackendBase {
         inferRequestsQueueServer_->set_warmup(warmup);
     }
 
-    std::vector<mlperf::QuerySampleResponse> get_query_sample_responses() {
-        return inferRequestsQueue_->get_query_sample_responses();
+    void set_warmup(bool warmup) {
+        inferRequestsQueue_->set_warmup(warmup);
     }
 
     // Progress tracker
@@ -105,26 +168,110 @@ class OVBackendBase {
         std::cout << progress_str << "\r" << std::flush;
     }
 
-    void predict(Item input, std::vector<float>& results,
-                std::vector<mlperf::ResponseId>& response_ids,
-                std::vector<unsigned>& counts) {
-        for (size_t j = 0; j < input_blob_names_.size(); j++) {
-            inferRequest_.set_tensor(input_blob_names_[j], input.tensors_[j]);
+    void predict(const Item &input, ResponseArena& arena) {
+        auto start = std::chrono::steady_clock::now();
+        if (ov_properties_.prebind_inputs) {
+            if (!bound_inputs_[0]) {
+                bind_inputs();
+            }
+            copy_to_bound_inputs<Workload>(input, bound_inputs_);
+        } else {
+            for (size_t j = 0; j < Workload::num_inputs; j++) {
+                inferRequest_.set_tensor(input_ports_[j], input.tensors_[j]);
+            }
         }
+        binding_stats_.add(start, input.sample_idxs_.size());
 
         inferRequest_.infer();
-        post_processor_(input, inferRequest_, results, response_ids, 1, counts);
+        arena.clear();
+        Workload::postprocess(input, inferRequest_, output_ports_, arena, 1);
     }
 
-    void predict_async(std::vector<Item> input_items) {
-        for (size_t j = 0; j < input_items.size(); ++j) {
-            auto inferRequest = inferRequestsQueue_->get_idle_request();
-            inferRequest->set_inputs(input_items[j]);
-            inferRequest->start_async();
+    // SingleStream fast path: the request keeps its own input tensors bound, samples are
+    // copied into them instead of calling set_tensor() per query
+    void bind_inputs() {
+        for (size_t j = 0; j < Workload::num_inputs; j++) {
+            bound_inputs_[j] = inferRequest_.get_tensor(input_ports_[j]);
         }
+    }
+
+    // Lets the QSL gather SingleStream samples straight into the bound inputs
+    void stage_inputs(Item &input) {
+        input.staging_.assign(bound_inputs_.begin(), bound_inputs_.end());
+        input.staged_ = true;
+    }
+
+    void predict_bound(const Item &input, ResponseArena& arena, bool busy_poll) {
+        auto start = std::chrono::steady_clock::now();
+        copy_to_bound_inputs<Workload>(input, bound_inputs_);
+        binding_stats_.add(start, input.sample_idxs_.size());
+
+        if (busy_poll) {
+            // Spin on the request status instead of sleeping in infer()
+            inferRequest_.start_async();
+            while (!inferRequest_.wait_for(std::chrono::milliseconds(0))) {
+            }
+        } else {
+            inferRequest_.infer();
+        }
+        arena.clear();
+        Workload::postprocess(input, inferRequest_, output_ports_, arena, 1);
+    }
+
+    // Runs the first num_items Items; the caller keeps them alive until wait_all() returns
+    void predict_async(std::vector<Item> &input_items, size_t num_items) {
+        for (size_t j = 0; j < num_items; ++j) {
+            submit_async(input_items[j]);
+        }
+        wait_all();
+    }
+
+    // Starts one Item on the next idle request; blocks only while every request is busy
+    void submit_async(Item &input_item) {
+        auto inferRequest = inferRequestsQueue_->get_idle_request();
+        inferRequest->set_inputs(input_item);
+        inferRequest->start_async();
+    }
+
+    // Takes the next idle request first and lets fill(&input_item) build the batch, so with
+    // pre-bound inputs the QSL gathers it straight into the request's tensors
+    template <typename Fill>
+    void submit_async(Item &input_item, Fill fill) {
+        auto inferRequest = inferRequestsQueue_->get_idle_request();
+        inferRequest->stage_inputs(input_item);
+        fill(&input_item);
+        inferRequest->set_inputs(input_item);
+        inferRequest->start_async();
+    }
+
+    void wait_all() {
         inferRequestsQueue_->wait_all();
     }
 
+    // Starts items[i] on a distinct request and waits for all of them, so every request
+    // runs exactly once when items holds get_nireq() Items
+    void run_on_all_requests(const std::vector<Item*>& items) {
+        if (inferRequestsQueue_) {
+            run_on_all_requests(*inferRequestsQueue_, items);
+        } else {
+            run_on_all_requests(*inferRequestsQueueServer_, items);
+        }
+    }
+
+    template <typename Queue>
+    static void run_on_all_requests(Queue& queue, const std::vector<Item*>& items) {
+        // Every request is taken before any starts, so a fast one cannot be picked twice
+        std::vector<typename Queue::Request::Ptr> requests;
+        for (size_t i = 0; i < items.size(); ++i) {
+            requests.push_back(queue.get_idle_request());
+        }
+        for (size_t i = 0; i < items.size(); ++i) {
+            requests[i]->set_inputs(*items[i]);
+            requests[i]->start_async();
+        }
+        queue.wait_all();
+    }
+
     void print_input_outputs_info(const std::shared_ptr<ov::Model>& model) {
         std::cout << "    [INFO] Model inputs:" << std::endl;
         for (auto&& param : model->get_parameters()) {
@@ -138,7 +285,7 @@ class OVBackendBase {
         }
     }
 
-    void predict_async_server(Item input_item) {
+    void predict_async_server(Item &input_item) {
         auto inferRequest = inferRequestsQueueServer_->get_idle_request();
 
         inferRequest->set_inputs(input_item);
@@ -146,8 +293,53 @@ class OVBackendBase {
         return;
     }
 
+    RequestsQueueServer& server_requests() {
+        return *inferRequestsQueueServer_;
+    }
+
+    // Lets the caller gather a batch straight into the request's inputs before starting it
+    typename RequestsQueueServer::Request::Ptr get_idle_server_request() {
+        return inferRequestsQueueServer_->get_idle_request();
+    }
+
+    void predict_async_server(const typename RequestsQueueServer::Request::Ptr& inferRequest, Item &input_item) {
+        inferRequest->set_inputs(input_item);
+        inferRequest->start_async();
+    }
+
+    // Average host time from a filled Item to a request ready to start
+    void report_input_binding() {
+        InputBindingStats stats = binding_stats_;
+        if (inferRequestsQueue_) {
+            for (const auto& request : inferRequestsQueue_->requests) {
+                stats += request->binding_stats();
+            }
+        }
+        if (inferRequestsQueueServer_) {
+            for (const auto& request : inferRequestsQueueServer_->requests) {
+                stats += request->binding_stats();
+            }
+        }
+        if (stats.batches == 0) {
+            return;
+        }
+        bool prebound = ov_properties_.prebind_inputs || settings_.scenario == mlperf::TestScenario::SingleStream;
+        std::cout << "    [INFO] Input binding (" << (prebound ? "pre-bound tensors" : "set_tensor") << "): "
+                  << std::fixed << std::setprecision(2) << stats.us / stats.batches << " us per query batch, "
+                  << stats.us / std::max<uint64_t>(stats.samples, 1) << " us per sample over "
+                  << stats.batches << " batches" << std::endl;
+    }
+
     void load() {
+        // Compiling on the instance's cores lets the CPU plugin place its stream threads
+        // there; by default an instance uses all of its cores
+        ScopedThreadAffinity affinity(ov_properties_.cores);
+        if (!ov_properties_.cores.empty() && ov_properties_.nthreads == 0) {
+            ov_properties_.nthreads = ov_properties_.cores.size();
+        }
+        ResidentMemory memory_before = ResidentMemory::current();
         ov::Core core_;
+        core_.set_property(ov::enable_mmap(ov_properties_.mmap_weights));
 
         // Load model to device
         auto devices = parse_devices(ov_properties_.device);
@@ -204,37 +396,133 @@ class OVBackendBase {
             }
         }
         std::cout << "    [INFO] Input model: " << input_model_ << std::endl;
-        auto model_ = core_.read_model(input_model_);
-
-        std::cout << "    [INFO] Setting pre-processing..." << std::endl;
-        auto preproc = ov::preprocess::PrePostProcessor(model_);
-        for (const auto& input : model_->inputs()) {
-            auto& in = preproc.input(input.get_any_name());
-            if (workload_.compare("resnet50") == 0 ||
-                workload_.compare("retinanet") == 0) {
-                in.tensor().set_element_type(ov::element::u8);
-            } else if (workload_.compare("bert") == 0) {
-                in.tensor().set_element_type(ov::element::i32);
-            }
+
+        std::unique_ptr<CompiledModelCache> model_cache;
+        std::string cache_key;
+        bool cache_hit = false;
+        if (!ov_properties_.cache_dir.empty()) {
+            model_cache = std::unique_ptr<CompiledModelCache>(new CompiledModelCache(ov_properties_.cache_dir));
+            cache_key = model_cache->make_key(input_model_, compile_options_description());
+            cache_hit = model_cache->import(cache_key, core_, ov_properties_.device, device_config, compiled_model_);
         }
-        model_ = preproc.build();
 
-        print_input_outputs_info(model_);
+        if (!cache_hit) {
+            auto compile_start = std::chrono::steady_clock::now();
+            auto model_ = core_.read_model(input_model_);
+
+            std::cout << "    [INFO] Setting pre-processing..." << std::endl;
+            auto preproc = ov::preprocess::PrePostProcessor(model_);
+            for (const auto& input : model_->inputs()) {
+                auto& in = preproc.input(input.get_any_name());
+                in.tensor().set_element_type(Workload::input_element_type());
+                if (ov_properties_.graph_preprocess_size > 0) {
+                    // Type and color conversion and the layout change run in the graph, where the
+                    // plugin can fuse them with the first convolution. Images stored at the model
+                    // size were resampled once on the host; other sizes add a resize here.
+                    size_t size = ov_properties_.graph_preprocess_size;
+                    const ov::PartialShape& model_shape = input.get_partial_shape();
+                    bool resize = !(model_shape[2].is_static() && model_shape[3].is_static() &&
+                                    static_cast<size_t>(model_shape[2].get_length()) == size &&
+                                    static_cast<size_t>(model_shape[3].get_length()) == size);
+                    std::cout << "    [INFO] Preprocessing " << size << "x" << size << " NHWC BGR images in the graph"
+                              << (resize ? " with a linear resize" : "") << std::endl;
+                    in.tensor().set_layout("NHWC")
+                               .set_color_format(ov::preprocess::ColorFormat::BGR)
+                               .set_spatial_static_shape(size, size);
+                    in.model().set_layout("NCHW");
+                    in.preprocess().convert_element_type(ov::element::f32)
+                                   .convert_color(ov::preprocess::ColorFormat::RGB);
+                    if (resize) {
+                        in.preprocess().resize(ov::preprocess::ResizeAlgorithm::RESIZE_LINEAR);
+                    }
+                }
+            }
+            model_ = preproc.build();
 
-        std::cout << "    [INFO] Setting batch size " + std::to_string(batch_size_) + "..." << std::endl;
-        ov::set_batch(model_, batch_size_);
+            if (ov_properties_.ingraph_topk) {
+                std::cout << "    [INFO] Appending TopK(1) to " << Workload::output_names[0] << "..." << std::endl;
+                append_top1(model_, Workload::output_names[0]);
+            }
+            if (ov_properties_.zero_copy_outputs) {
+                std::cout << "    [INFO] Interleaving outputs into " << Workload::response_output_name << "..." << std::endl;
+                interleave_outputs(model_, mlperf_ov::to_names(Workload::output_names), Workload::response_output_name);
+            }
+
+            print_input_outputs_info(model_);
 
-        std::cout << "    [INFO] Loading network to device " + ov_properties_.device + "..." << std::endl;
-        compiled_model_ = core_.compile_model(model_, ov_properties_.device, device_config);
+            if (ov_properties_.seq_buckets.empty() && !ov_properties_.dynamic_batch) {
+                std::cout << "    [INFO] Setting batch size " + std::to_string(batch_size_) + "..." << std::endl;
+                ov::set_batch(model_, batch_size_);
+            } else {
+                // One compiled model serves every bucket and partial batch; the upper bounds
+                // let the device plan for the largest shape
+                ov::Dimension batch = ov_properties_.dynamic_batch
+                        ? ov::Dimension(1, static_cast<int64_t>(batch_size_))
+                        : ov::Dimension(batch_size_);
+                std::string message = "    [INFO] Setting batch size " +
+                        std::string(ov_properties_.dynamic_batch ? "1.." : "") + std::to_string(batch_size_);
+                if (!ov_properties_.seq_buckets.empty()) {
+                    message += " and dynamic sequence length up to " + std::to_string(ov_properties_.seq_buckets.back());
+                }
+                std::cout << message << "..." << std::endl;
+                std::map<std::string, ov::PartialShape> shapes;
+                for (const auto& input : model_->inputs()) {
+                    ov::PartialShape shape = input.get_partial_shape();
+                    shape[0] = batch;
+                    if (!ov_properties_.seq_buckets.empty()) {
+                        shape[1] = ov::Dimension(1, static_cast<int64_t>(ov_properties_.seq_buckets.back()));
+                    }
+                    shapes[input.get_any_name()] = shape;
+                }
+                model_->reshape(shapes);
+            }
+
+            std::cout << "    [INFO] Loading network to device " + ov_properties_.device + "..." << std::endl;
+            compiled_model_ = core_.compile_model(model_, ov_properties_.device, device_config);
+
+            if (model_cache) {
+                model_cache->store(cache_key, compiled_model_, CompiledModelCache::elapsed_ms(compile_start));
+            }
+        }
 
         std::cout << "    [INFO] Network loaded to device" << std::endl;
+
+        for (size_t j = 0; j < Workload::num_inputs; j++) {
+            input_ports_[j] = compiled_model_.input(Workload::input_names[j]);
+        }
+        output_ports_ = mlperf_ov::resolve_output_ports<Workload>(compiled_model_, ov_properties_.zero_copy_outputs);
+        if (ov_properties_.zero_copy_outputs) {
+            // The interleaved output is the responses of a full batch
+            max_response_size_ = ov::shape_size(output_ports_.response.get_shape());
+        } else {
+            std::vector<ov::Shape> output_shapes;
+            for (size_t j = 0; j < Workload::num_outputs; j++) {
+                output_shapes.push_back(output_ports_.outputs[j].get_partial_shape().get_max_shape());
+            }
+            max_response_size_ = Workload::max_response_size(output_shapes);
+        }
+        init_response_arena(warmup_arena_);
         auto supported_properties = compiled_model_.get_property(ov::supported_properties);
         for (const auto& cfg : supported_properties) {
             if (cfg == ov::supported_properties) continue;
             auto prop = compiled_model_.get_property(cfg);
-            if (cfg == ov::optimal_number_of_infer_requests) ov_properties_.nireq = prop.as<uint32_t>();
+            // An explicit --nireq wins over the device's optimal number
+            if (cfg == ov::optimal_number_of_infer_requests && ov_properties_.nireq == 0) {
+                ov_properties_.nireq = prop.as<uint32_t>();
+            }
             std::cout << "    [INFO] " << cfg << ": " << prop.as<std::string>() << std::endl;
         }
+        if (ov_properties_.nireq == 0) {
+            ov_properties_.nireq = 1;
+        }
+        if (elastic_requests()) {
+            // Every request the pool may grow to is created up front; the SUT's controller
+            // takes the pool down to the initial size once the test starts
+            initial_nireq_ = ov_properties_.nireq;
+            ov_properties_.nireq = std::max(ov_properties_.nireq_max, ov_properties_.nireq_min);
+            std::cout << "    [INFO] Elastic request pool: " << ov_properties_.nireq_min << ".." << ov_properties_.nireq
+                      << " requests, starting at " << initial_nireq_ << std::endl;
+        }
         std::cout << "    [INFO] Creating " << ov_properties_.nireq << " inference request(s)" << std::endl;
         if (settings_.scenario == mlperf::TestScenario::SingleStream) {
             set_infer_request();
@@ -244,55 +532,133 @@ class OVBackendBase {
         } else if (settings_.scenario == mlperf::TestScenario::Server) {
             create_server_requests();
         }
+        report_resident_memory(memory_before);
+    }
+
+    // Weights the plugin keeps in the mapped file stay file-backed; repacked or converted
+    // weights (e.g. to bf16) show up as anonymous memory of each backend
+    static void report_resident_memory(const ResidentMemory& before) {
+        ResidentMemory after = ResidentMemory::current();
+        if (after.total_kb == 0) {
+            return;
+        }
+        auto mb = [](size_t kb) { return kb / 1024.0; };
+        std::cout << "    [INFO] Resident memory after load: " << std::fixed << std::setprecision(1)
+                  << mb(after.total_kb) << " MB (+" << mb(after.total_kb - std::min(after.total_kb, before.total_kb))
+                  << " MB for this backend), file-backed " << mb(after.file_kb) << " MB, anonymous "
+                  << mb(after.anon_kb) << " MB" << std::endl;
+    }
+
+    // Replaces a classifier's scores output by the i32 index of its top score under the same
+    // tensor name, so requests read back one integer per sample instead of every class score
+    static void append_top1(const std::shared_ptr<ov::Model>& model, const std::string& output_name) {
+        auto result = std::dynamic_pointer_cast<ov::opset11::Result>(model->output(output_name).get_node_shared_ptr());
+        if (!result) {
+            throw std::runtime_error("Output " + output_name + " is not a model result");
+        }
+        ov::Output<ov::Node> scores = result->input_value(0);
+        auto k = std::make_shared<ov::opset11::Constant>(ov::element::i64, ov::Shape{}, std::vector<int64_t>{1});
+        auto topk = std::make_shared<ov::opset11::TopK>(scores, k, 1, "max", "none", ov::element::i32);
+
+        scores.get_tensor().set_names({});
+        topk->output(1).get_tensor().set_names({output_name});
+        model->remove_result(result);
+        model->add_results({std::make_shared<ov::opset11::Result>(topk->output(1))});
+    }
+
+    // Replaces same-shaped outputs by one output that stacks them on a new innermost axis,
+    // so element i of every output ends up adjacent, e.g. [start, end] logits per token
+    static void interleave_outputs(const std::shared_ptr<ov::Model>& model,
+                                   const std::vector<std::string>& output_names,
+                                   const std::string& interleaved_name) {
+        auto axis = std::make_shared<ov::opset11::Constant>(ov::element::i64, ov::Shape{}, std::vector<int64_t>{-1});
+        std::vector<ov::Output<ov::Node>> columns;
+        for (const auto& name : output_names) {
+            auto result = std::dynamic_pointer_cast<ov::opset11::Result>(model->output(name).get_node_shared_ptr());
+            if (!result) {
+                throw std::runtime_error("Output " + name + " is not a model result");
+            }
+            columns.push_back(std::make_shared<ov::opset11::Unsqueeze>(result->input_value(0), axis)->output(0));
+            model->remove_result(result);
+        }
+        auto interleaved = std::make_shared<ov::opset11::Concat>(columns, -1);
+        interleaved->output(0).get_tensor().set_names({interleaved_name});
+        model->add_results({std::make_shared<ov::opset11::Result>(interleaved->output(0))});
+    }
+
+    // Everything besides the model files that changes the compiled blob
+    std::string compile_options_description() const {
+        std::stringstream options;
+        options << "device=" << ov_properties_.device
+                << ";batch=" << batch_size_
+                << ";hint=" << (settings_.scenario == mlperf::TestScenario::SingleStream ? "LATENCY" : "THROUGHPUT")
+                << ";nstreams=" << ov_properties_.nstreams
+                << ";nthreads=" << ov_properties_.nthreads
+                << ";precision=" << ov_properties_.infer_precision
+                << ";auto_batching=" << ov_properties_.allow_auto_batching
+                << ";extensions=" << ov_properties_.extensions
+                << ";input_type=" << Workload::input_element_type()
+                << ";topk=" << ov_properties_.ingraph_topk
+                << ";graph_preprocess=" << ov_properties_.graph_preprocess_size
+                << ";max_seq_len=" << (ov_properties_.seq_buckets.empty() ? 0 : ov_properties_.seq_buckets.back())
+                << ";dynamic_batch=" << ov_properties_.dynamic_batch
+                << ";zero_copy_outputs=" << ov_properties_.zero_copy_outputs;
+        return options.str();
     }
 
     uint32_t get_nireq() {
         return ov_properties_.nireq;
     }
 
+    bool elastic_requests() const {
+        return settings_.scenario == mlperf::TestScenario::Server && ov_properties_.nireq_max > 0;
+    }
+
+    // Requests in service when an elastic pool starts resizing
+    uint32_t initial_nireq() const {
+        return initial_nireq_;
+    }
+
 public:
     ov::CompiledModel compiled_model_;
-    InferRequestsQueue* inferRequestsQueue_;
-    InferRequestsQueueServer* inferRequestsQueueServer_;
+    std::unique_ptr<RequestsQueue> inferRequestsQueue_;
+    std::unique_ptr<RequestsQueueServer> inferRequestsQueueServer_;
     ov::InferRequest inferRequest_;
+    std::array<ov::Output<const ov::Node>, Workload::num_inputs> input_ports_;
+    mlperf_ov::OutputPorts<Workload::num_outputs> output_ports_;
+    std::array<ov::Tensor, Workload::num_inputs> bound_inputs_;
+    // Bound output of inferRequest_ with zero_copy_outputs
+    std::vector<float> response_output_;
+    InputBindingStats binding_stats_;
     std::string input_model_;
-    std::vector<std::string> output_blob_names_;
-    std::vector<std::string> input_blob_names_;
     unsigned batch_size_ = 1;
     OVBackendProperties ov_properties_;
 
     mlperf::TestSettings settings_;
-    std::string workload_;
     int object_size_;
-
-    PPFunction post_processor_;
+    size_t max_response_size_ = 0;
+    ResponseArena warmup_arena_;
+    uint32_t initial_nireq_ = 0;
 };
 
-class OVBackendAsync : public OVBackendBase {
+template <typename Workload>
+class OVBackendAsync : public OVBackendBase<Workload> {
 public:
     OVBackendAsync(mlperf::TestSettings settings,
                     OVBackendProperties ov_properties,
                     unsigned batch_size,
-                    std::string workload,
-                    std::vector<std::string> input_blob_names,
-                    std::vector<std::string> output_blob_names,
-                    std::string input_model, PPFunction post_processor)
-        : OVBackendBase(settings, ov_properties, batch_size, workload, input_blob_names,
-                        output_blob_names, input_model, post_processor) {}
+                    std::string input_model)
+        : OVBackendBase<Workload>(settings, ov_properties, batch_size, input_model) {}
 };
 
-class OVBackendServer : public OVBackendBase {
+template <typename Workload>
+class OVBackendServer : public OVBackendBase<Workload> {
 public:
     OVBackendServer(mlperf::TestSettings settings,
                     OVBackendProperties ov_properties,
                     unsigned batch_size,
-                    std::string workload,
-                    std::vector<std::string> input_blob_names,
-                    std::vector<std::string> output_blob_names,
-                    std::string input_model,
-                    PPFunction post_processor)
-        : OVBackendBase(settings, ov_properties, batch_size, workload, input_blob_names,
-                        output_blob_names, input_model, post_processor) {}
+                    std::string input_model)
+        : OVBackendBase<Workload>(settings, ov_properties, batch_size, input_model) {}
 };
 
 #endif
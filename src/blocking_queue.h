@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+/// @brief Unbounded multi-producer / multi-consumer FIFO used to hand work between
+/// pipeline stages. push() is O(1) and never blocks on consumers.
+///
+/// Elements live in a ring buffer that only grows when full, so a queue that has
+/// reached its working depth no longer allocates.
+template <typename T>
+class BlockingQueue final {
+public:
+    explicit BlockingQueue(size_t initial_capacity = 64) :
+            buffer_(std::max<size_t>(initial_capacity, 1)) {}
+    ~BlockingQueue() = default;
+
+    BlockingQueue(const BlockingQueue&) = delete;
+    BlockingQueue& operator=(const BlockingQueue&) = delete;
+
+    void push(T value) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (size_ == buffer_.size()) {
+                grow();
+            }
+            buffer_[(head_ + size_) % buffer_.size()] = std::move(value);
+            ++size_;
+        }
+        cv_.notify_one();
+    }
+
+    /// Waits for an element. Returns false once the queue is closed and drained.
+    bool pop(T& value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return size_ > 0 || closed_; });
+        return pop_front(value);
+    }
+
+    /// Waits until @p deadline for an element. Returns false on timeout or close.
+    template <typename Clock, typename Duration>
+    bool pop_until(T& value, const std::chrono::time_point<Clock, Duration>& deadline) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!cv_.wait_until(lock, deadline, [this] { return size_ > 0 || closed_; })) {
+            return false;
+        }
+        return pop_front(value);
+    }
+
+    /// Wakes all consumers; pending elements can still be drained.
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+private:
+    bool pop_front(T& value) {
+        if (size_ == 0) {
+            return false;
+        }
+        value = std::move(buffer_[head_]);
+        head_ = (head_ + 1) % buffer_.size();
+        --size_;
+        return true;
+    }
+
+    void grow() {
+        std::vector<T> buffer(buffer_.size() * 2);
+        for (size_t i = 0; i < size_; ++i) {
+            buffer[i] = std::move(buffer_[(head_ + i) % buffer_.size()]);
+        }
+        buffer_.swap(buffer);
+        head_ = 0;
+    }
+
+    std::vector<T> buffer_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool closed_ = false;
+};
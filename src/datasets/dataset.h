@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <exception>
 #include <map>
+#include <thread>
 
 // loadgen
 #include "loadgen.h"
@@ -11,6 +14,7 @@
 #include "bindings/c_api.h"
 
 #include "item_ov.h"
+#include "numa.h"
 #include "workload_helpers.h"
 
 class QSLBase : mlperf::QuerySampleLibrary {
@@ -44,18 +48,165 @@ public:
         throw std::runtime_error("UnloadSamplesFromRam is not implemented in base class!");
     }
 
-    virtual void GetSample(const std::vector<mlperf::QuerySampleIndex> samples,
-        std::vector<mlperf::ResponseId> query_ids, size_t bs, Item *item) = 0;
+    // The getters below refill the caller's Items in place; the MultiStream getter grows
+    // `items` to at least num_batches and fills the first num_batches entries. A staged
+    // Item (Item::staged_) gets its samples copied into its staging tensors, never a view.
+    virtual void GetSample(const std::vector<mlperf::QuerySampleIndex>& samples,
+        const std::vector<mlperf::ResponseId>& query_ids, size_t bs, Item *item) = 0;
 
-    virtual void GetSamplesBatched(const std::vector<mlperf::QuerySampleIndex> samples,
-        std::vector<mlperf::ResponseId> query_ids, size_t bs, int num_batches, std::vector<Item> &items) = 0;
+    // Fills batch batch_idx of an Offline query, i.e. samples [batch_idx * bs, (batch_idx + 1) * bs)
+    virtual void GetSamplesBatch(const std::vector<mlperf::QuerySampleIndex>& samples,
+        const std::vector<mlperf::ResponseId>& query_ids, size_t bs, size_t batch_idx, Item *item) = 0;
 
-    virtual void GetSamplesBatchedServer(const std::vector<mlperf::QuerySampleIndex> samples,
-        std::vector<mlperf::ResponseId> query_ids, size_t bs, int num_batches, std::vector<Item> &items) = 0;
+    // Fills samples [begin, begin + count) of an Offline/MultiStream query, count <= bs, usually
+    // its partial last batch: a zero-copy view of count samples for a model with a dynamic batch,
+    // or with pad a copy filled up to bs with the last sample for a statically batched one
+    virtual void GetSamplesTail(const std::vector<mlperf::QuerySampleIndex>& samples,
+        const std::vector<mlperf::ResponseId>& query_ids, size_t begin, size_t count, size_t bs,
+        bool pad, Item *item) = 0;
 
-    virtual void GetSamplesBatchedMultistream(const std::vector<mlperf::QuerySampleIndex> samples,
-        std::vector<mlperf::ResponseId> query_ids, size_t bs, int num_batches, std::vector<Item> &items) = 0;
+    // Copies up to bs samples into one batch; partial batches are padded with the last sample
+    virtual void GetSamplesBatchedServer(const std::vector<mlperf::QuerySampleIndex>& samples,
+        const std::vector<mlperf::ResponseId>& query_ids, size_t bs, Item *item) = 0;
 
+    virtual void GetSamplesBatchedMultistream(const std::vector<mlperf::QuerySampleIndex>& samples,
+        const std::vector<mlperf::ResponseId>& query_ids, size_t bs, int num_batches, std::vector<Item> &items) = 0;
+
+    // Number of real (unpadded) tokens of a sample; only token datasets support buckets
+    virtual size_t GetSampleLength(mlperf::QuerySampleIndex sample) {
+        throw std::runtime_error("Sequence buckets are not supported by " + Name());
+    }
+
+    // Copies samples [begin, begin + count) truncated to seq_len tokens into the Item's
+    // staging buffers of that bucket; partial batches are padded with the last sample
+    virtual void GetSamplesBucket(const std::vector<mlperf::QuerySampleIndex>& samples,
+        const std::vector<mlperf::ResponseId>& query_ids, size_t begin, size_t count, size_t bs,
+        size_t bucket, size_t seq_len, Item *item) {
+        throw std::runtime_error("Sequence buckets are not supported by " + Name());
+    }
+
+    // Splits loaded samples into one shard per NUMA backend instance. Shard s is written by a
+    // thread pinned to shard_cores[s], so first-touch places its pages on that node; shard
+    // boundaries are multiples of align, so no aligned batch view spans two nodes.
+    void set_numa_shards(const std::vector<std::vector<int>>& shard_cores, size_t align) {
+        shard_cores_ = shard_cores;
+        shard_align_ = std::max<size_t>(align, 1);
+    }
+
+    // Worker threads decoding samples in LoadSamplesToRam, split across NUMA shards;
+    // 0 uses every hardware thread
+    void set_load_threads(size_t threads) {
+        load_threads_ = threads;
+    }
+
+    // Shard holding a loaded sample position; 0 without NUMA shards
+    size_t GetSampleShard(size_t position) const {
+        return shard_size_ == 0 ? 0 : std::min(position / shard_size_, shard_cores_.size() - 1);
+    }
+
+    // Loaded position of query sample `begin` in the positional Offline/MultiStream layouts
+    size_t GetQueryPosition(const std::vector<mlperf::QuerySampleIndex>& samples, size_t begin) {
+        if (settings_.scenario == mlperf::TestScenario::MultiStream) {
+            auto it = std::find(sample_list_inmemory_.begin(), sample_list_inmemory_.end(), samples[0]);
+            if (it == sample_list_inmemory_.end()) {
+                throw std::logic_error("Sample " + std::to_string(samples[0]) + " is not loaded");
+            }
+            return std::distance(sample_list_inmemory_.begin(), it) + begin;
+        }
+        return begin % perf_count_;
+    }
+
+    void ReserveItems(std::vector<Item> &items, int num_batches) {
+        if (items.size() < (size_t) num_batches) {
+            items.resize(num_batches);
+        }
+    }
+
+protected:
+    // Calls load(begin, end) over the sample positions [0, num_samples): inline, or once
+    // per NUMA shard on a thread pinned to the shard's cores
+    template <typename Load>
+    void ForEachShard(size_t num_samples, Load load) {
+        size_t num_shards = shard_cores_.size();
+        if (num_shards < 2) {
+            load(0, num_samples);
+            return;
+        }
+        // Rounded down to whole batches; the last shard also takes the remainder
+        shard_size_ = std::max(shard_align_, num_samples / num_shards / shard_align_ * shard_align_);
+
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> errors(num_shards);
+        for (size_t s = 0; s < num_shards; ++s) {
+            size_t begin = std::min(num_samples, s * shard_size_);
+            size_t end = (s + 1 == num_shards) ? num_samples : std::min(num_samples, begin + shard_size_);
+            threads.emplace_back([&, s, begin, end]() {
+                pin_current_thread(shard_cores_[s]);
+                try {
+                    load(begin, end);
+                } catch (...) {
+                    errors[s] = std::current_exception();
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    // Workers of each ForEachShard range
+    size_t LoadThreadsPerShard() const {
+        size_t threads = load_threads_ > 0 ? load_threads_ : std::max(1u, std::thread::hardware_concurrency());
+        return std::max<size_t>(1, threads / std::max<size_t>(1, shard_cores_.size()));
+    }
+
+    // Calls load(i) for every position in [begin, end) on `threads` workers that take the next
+    // position from a shared counter, so a few slow samples do not hold up a fixed range.
+    // Workers inherit the calling thread's affinity; the first error is rethrown.
+    template <typename Load>
+    static void ParallelFor(size_t begin, size_t end, size_t threads, Load load) {
+        threads = std::min(threads, end - std::min(begin, end));
+        if (threads < 2) {
+            for (size_t i = begin; i < end; ++i) {
+                load(i);
+            }
+            return;
+        }
+
+        std::atomic<size_t> next(begin);
+        std::atomic<bool> failed(false);
+        std::vector<std::exception_ptr> errors(threads);
+        auto work = [&](size_t worker) {
+            try {
+                for (size_t i = next++; i < end && !failed; i = next++) {
+                    load(i);
+                }
+            } catch (...) {
+                errors[worker] = std::current_exception();
+                failed = true;
+            }
+        };
+        std::vector<std::thread> workers;
+        for (size_t w = 1; w < threads; ++w) {
+            workers.emplace_back(work, w);
+        }
+        work(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+public:
     std::vector<mlperf::QuerySampleIndex> sample_list_inmemory_;
     size_t total_count_;
     size_t perf_count_;
@@ -64,4 +215,8 @@ public:
     mlperf_ov::WorkloadName workload_name_;
     mlperf_ov::DatasetName dataset_name_;
     unsigned char * handle;
+    std::vector<std::vector<int>> shard_cores_;
+    size_t shard_align_ = 1;
+    size_t shard_size_ = 0;
+    size_t load_threads_ = 0;
 };
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/foreach.hpp>
+#include <chrono>
+#include <iomanip>
 #include <map>
 
 // loadgen
@@ -11,6 +13,7 @@
 #include "query_sample_library.h"
 #include "test_settings.h"
 #include "dataset.h"
+#include "sample_cache.h"
 
 #include <openvino/openvino.hpp>
 
@@ -52,54 +55,161 @@ public:
             }
         }
 
-        mlperf::QuerySampleIndex sample;
+        ov::Shape shape = sample_shape();
+        size_t sample_bytes = ov::shape_size(shape);
+        if (sample_cache_ && !sample_cache_->is_open()) {
+            OpenSampleCache(sample_bytes);
+        }
+        bool cached = sample_cache_ && sample_cache_->is_open();
+        if (cached) {
+            FillSampleCache(samples, sample_bytes);
+        }
+        // Per-sample tensors can be slices of the cache mapping; Offline and MultiStream batch
+        // views need the loaded samples contiguous in query order, so they still get a slab
+        // copied from the cache
+        bool mapped = cached && ((settings_.scenario == mlperf::TestScenario::SingleStream)
+                || (settings_.scenario == mlperf::TestScenario::Server));
+        handle = mapped ? nullptr : (new unsigned char[samples.size() * sample_bytes]);
+
+        // Each worker decodes or copies from the cache into its own slots of the slab; the tensors
+        // over them are registered afterwards on this thread
+        auto load_start = std::chrono::steady_clock::now();
+        size_t threads = LoadThreadsPerShard();
+        if (!mapped) {
+            ForEachShard(samples.size(), [&](size_t begin, size_t end) {
+                ParallelFor(begin, end, threads, [&](size_t i) {
+                    if (cached) {
+                        std::memcpy(handle + i * sample_bytes, CachedSample(samples[i]), sample_bytes);
+                    } else {
+                        LoadImage(samples[i], handle + i * sample_bytes, sample_bytes);
+                    }
+                });
+            });
+        }
+        double load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+
+        for (size_t i = 0; i < samples.size(); ++i) {
+            mlperf::QuerySampleIndex sample = samples[i];
+            // Mapped samples are read-only; nothing writes to loaded samples
+            unsigned char* data = mapped ? const_cast<unsigned char*>(CachedSample(sample)) : handle + i * sample_bytes;
+            ov::Tensor input_tensor = ov::Tensor(ov::element::u8, shape, data);
 
-        ov::Shape shape;
-        handle = (new unsigned char[samples.size() * num_channels_ * image_height_ * image_width_]);
+            if (settings_.scenario == mlperf::TestScenario::Offline) {
+                image_list_inmemory_[i] = input_tensor;
+            } else if ((settings_.scenario == mlperf::TestScenario::SingleStream)
+                    || (settings_.scenario == mlperf::TestScenario::Server)) {
+                image_list_inmemory_[sample] = input_tensor;
+            } else if (this->settings_.scenario == mlperf::TestScenario::MultiStream) {
+                image_list_inmemory_[i] = input_tensor;
+                sample_list_inmemory_[i] = sample;
+            }
+        }
 
-        for (uint i = 0; i < samples.size(); ++i) {
-            cv::Mat processed_image;
-            sample = samples[i];
+        std::cout << "    [INFO] Loaded " << samples.size() << " images"
+                  << (mapped ? " mapped from" : cached ? " copied from" : "")
+                  << (cached ? " the sample cache" : "") << " in " << std::fixed << std::setprecision(1)
+                  << load_ms << " ms (" << samples.size() * 1000.0 / std::max(load_ms, 1e-3) << " images/s, "
+                  << threads * std::max<size_t>(1, shard_cores_.size()) << " threads)" << std::endl;
+    }
 
-            std::string image_path;
+    // Keeps preprocessed samples in cache_dir across runs; empty disables the cache
+    void set_sample_cache(const std::string& cache_dir) {
+        sample_cache_.reset(cache_dir.empty() ? nullptr : new PreprocessedSampleCache(cache_dir));
+    }
 
-            if (sample >= image_list_.size()) {
-                throw std::logic_error("Sample is out of image list: " +
-                    std::to_string(sample) + " >= " + std::to_string(image_list_.size()));
-            }
+    // Maps this configuration's cache file; samples are preprocessed into it as they are loaded
+    void OpenSampleCache(size_t sample_bytes) {
+        std::stringstream prefix, description;
+        prefix << dataset_name_ << "_" << workload_name_;
+        description << "dataset=" << dataset_name_ << ";workload=" << workload_name_
+                    << ";version=" << kPreprocessVersion << ";shape=" << sample_shape()
+                    << ";graph_preprocess=" << graph_preprocess_size_ << ";data=" << datapath_ << ";images=";
+        for (const auto& image : image_list_) {
+            description << image << ",";
+        }
+        std::string key = sample_cache_->make_key(prefix.str(), description.str());
+        sample_cache_->open(key, TotalSampleCount(), sample_bytes);
+    }
 
-            if (dataset_name_ == mlperf_ov::DatasetName::ImageNet2012) {
-                image_path = this->datapath_ + "/" + image_list_[sample];
-            }
-            else if (dataset_name_ == mlperf_ov::DatasetName::OpenImages_v6) {
-                image_path = this->datapath_ + "/validation/data/" + image_list_[sample];
+    // Preprocesses the loaded samples the cache does not hold yet straight into their slots
+    void FillSampleCache(const std::vector<mlperf::QuerySampleIndex>& samples, size_t sample_bytes) {
+        std::vector<mlperf::QuerySampleIndex> missing_samples;
+        for (auto sample : samples) {
+            if (!sample_cache_->filled(sample)) {
+                missing_samples.push_back(sample);
             }
+        }
+        if (missing_samples.empty()) {
+            return;
+        }
+        std::cout << "    [WARNING] " << missing_samples.size() << " of " << samples.size() << " loaded images are "
+                  << "not in the sample cache yet; preprocessing them into it makes this load slower" << std::endl;
+
+        auto start = std::chrono::steady_clock::now();
+        size_t threads = LoadThreadsPerShard() * std::max<size_t>(1, shard_cores_.size());
+        ParallelFor(0, missing_samples.size(), threads, [&](size_t i) {
+            mlperf::QuerySampleIndex sample = missing_samples[i];
+            LoadImage(sample, sample_cache_->sample(sample), sample_bytes);
+        });
+        sample_cache_->flush();
+        for (auto sample : missing_samples) {
+            sample_cache_->set_filled(sample);
+        }
+        sample_cache_->flush();
+        std::cout << "    [INFO] Preprocessed " << missing_samples.size() << " images into the sample cache in "
+                  << std::fixed << std::setprecision(1) << std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start).count() << " ms" << std::endl;
+    }
 
-            auto image = cv::imread(image_path);
+    const unsigned char* CachedSample(mlperf::QuerySampleIndex sample) const {
+        if (sample >= image_list_.size()) {
+            throw std::logic_error("Sample is out of image list: " +
+                std::to_string(sample) + " >= " + std::to_string(image_list_.size()));
+        }
+        return sample_cache_->sample(sample);
+    }
 
-            if (image.empty()) {
-                throw std::logic_error("Invalid image at path: " + image_path);
-            }
+    // Decodes and preprocesses one image into sample_bytes at input_data, in the layout of sample_shape()
+    void LoadImage(mlperf::QuerySampleIndex sample, unsigned char* input_data, size_t sample_bytes) {
+        cv::Mat processed_image;
+        std::string image_path;
 
-            if (this->workload_name_ == mlperf_ov::WorkloadName::ResNet50) {
-                shape = ov::Shape{ 1, num_channels_, image_height_, image_width_ };
-                preprocess_resnet50(&image, &processed_image);
-            } else if (this->workload_name_ == mlperf_ov::WorkloadName::RetinaNet) {
-                shape = ov::Shape{ 1, num_channels_, image_height_, image_width_ };
-                preprocess_retinanet(&image, &processed_image);
-            } else {
-                std::stringstream ss;
-                ss << "Workload is not supported: " << this->workload_name_;
-                throw std::runtime_error(ss.str());
-            }
+        if (sample >= image_list_.size()) {
+            throw std::logic_error("Sample is out of image list: " +
+                std::to_string(sample) + " >= " + std::to_string(image_list_.size()));
+        }
 
-            processed_image.copyTo(image);
-            size_t image_size = (image_height_ * image_width_);
+        if (dataset_name_ == mlperf_ov::DatasetName::ImageNet2012) {
+            image_path = this->datapath_ + "/" + image_list_[sample];
+        }
+        else if (dataset_name_ == mlperf_ov::DatasetName::OpenImages_v6) {
+            image_path = this->datapath_ + "/validation/data/" + image_list_[sample];
+        }
 
-            ov::Tensor input_tensor = ov::Tensor(ov::element::u8, shape,
-                ((((unsigned char *) handle) + (i * image_size * num_channels_))));
-            auto input_data = input_tensor.data<unsigned char>();
+        auto image = cv::imread(image_path);
 
+        if (image.empty()) {
+            throw std::logic_error("Invalid image at path: " + image_path);
+        }
+
+        if (graph_preprocess_size_ > 0) {
+            preprocess_for_graph(&image, &processed_image);
+        } else if (this->workload_name_ == mlperf_ov::WorkloadName::ResNet50) {
+            preprocess_resnet50(&image, &processed_image);
+        } else if (this->workload_name_ == mlperf_ov::WorkloadName::RetinaNet) {
+            preprocess_retinanet(&image, &processed_image);
+        } else {
+            std::stringstream ss;
+            ss << "Workload is not supported: " << this->workload_name_;
+            throw std::runtime_error(ss.str());
+        }
+
+        if (graph_preprocess_size_ > 0) {
+            // Already NHWC BGR as the compiled graph expects
+            std::memcpy(input_data, processed_image.data, sample_bytes);
+        } else {
+            processed_image.copyTo(image);
+            size_t image_size = (image_height_ * image_width_);
             for (size_t image_id = 0; image_id < 1; ++image_id) {
                 for (size_t pid = 0; pid < image_size; pid++) {
                     for (size_t ch = 0; ch < num_channels_; ++ch) {
@@ -108,20 +218,11 @@ public:
                     }
                 }
             }
-
-            if (settings_.scenario == mlperf::TestScenario::Offline) {
-                image_list_inmemory_[i] = input_tensor;
-            } else if ((settings_.scenario == mlperf::TestScenario::SingleStream)
-                    || (settings_.scenario == mlperf::TestScenario::Server)) {
-                image_list_inmemory_[sample] = input_tensor;
-            } else if (this->settings_.scenario == mlperf::TestScenario::MultiStream) {
-                image_list_inmemory_[i] = input_tensor;
-                sample_list_inmemory_[i] = sample;
-            }
         }
     }
 
     void UnloadSamplesFromRam(const std::vector<mlperf::QuerySampleIndex>& samples) override {
+        batch_views_.clear();
         image_list_inmemory_.clear();
         delete [] handle;
     }
@@ -133,64 +234,81 @@ public:
         }
     }
 
-    void GetSample(const std::vector<mlperf::QuerySampleIndex> samples,
-            std::vector<mlperf::ResponseId> query_ids, size_t bs, Item *item) {
+    void GetSample(const std::vector<mlperf::QuerySampleIndex>& samples,
+            const std::vector<mlperf::ResponseId>& query_ids, size_t bs, Item *item) {
         auto sample_idx = samples[0];
-        std::vector<ov::Tensor> input { image_list_inmemory_[sample_idx] };
-		*item = Item(input, query_ids, samples);
+        item->tensors_.resize(1);
+        if (item->staged_) {
+            CopyToStaging(image_list_inmemory_[sample_idx].data(), 1, item);
+        } else {
+            item->tensors_[0] = image_list_inmemory_[sample_idx];
+        }
+        item->set_samples(samples, query_ids, 0, samples.size());
     }
 
-    void GetSamplesBatched(const std::vector<mlperf::QuerySampleIndex> samples,
-            std::vector<mlperf::ResponseId> query_ids, size_t bs, int num_batches, std::vector<Item> &items) {
-        size_t image_size = (image_height_ * image_width_);
-        ov::Shape shape { (bs), num_channels_, image_height_, image_width_ };
-
-		for (int i = 0; i < num_batches; ++i) {
-			auto start = (i * bs) % perf_count_;
-            std::vector<ov::Tensor> inputs { ov::Tensor(ov::element::u8, shape, image_list_inmemory_[start].data())};
-
-			std::vector<mlperf::QuerySampleIndex> idxs;
-			std::vector<mlperf::ResponseId> ids;
-			for (size_t j = (i * bs); j < (unsigned) ((i * bs) + bs); ++j) {
-				ids.push_back(query_ids[j]);
-				idxs.push_back(samples[j]);
-			}
-			items.push_back(Item(inputs, ids, idxs));
-		}
+    void GetSamplesBatch(const std::vector<mlperf::QuerySampleIndex>& samples,
+            const std::vector<mlperf::ResponseId>& query_ids, size_t bs, size_t batch_idx, Item *item) {
+        auto start = (batch_idx * bs) % perf_count_;
+        item->tensors_.resize(1);
+        if (item->staged_) {
+            CopyToStaging(image_list_inmemory_[start].data(), bs, item);
+        } else {
+            item->tensors_[0] = GetBatchView(start, bs);
+        }
+        item->set_samples(samples, query_ids, batch_idx * bs, bs);
     }
 
-
-    void GetSamplesBatchedServer(const std::vector<mlperf::QuerySampleIndex> samples,
-            std::vector<mlperf::ResponseId> query_ids, size_t bs, int num_batches, std::vector<Item> &items) {
-        size_t image_size = (image_height_ * image_width_);
-        ov::Shape shape { (bs), num_channels_, image_height_, image_width_ };
-
-        for (int i = 0; i < num_batches; ++i) {
-            ov::Tensor input = ov::Tensor(ov::element::u8, shape);
-            for (size_t k = 0; k < bs; ++k) {
-                auto start = samples[k];
-                std::memcpy((input.data<unsigned char>() + (k * image_size * num_channels_)),
-                        image_list_inmemory_[start].data(),
-                        (image_size * num_channels_ * sizeof(unsigned char)));
+    void GetSamplesTail(const std::vector<mlperf::QuerySampleIndex>& samples,
+            const std::vector<mlperf::ResponseId>& query_ids, size_t begin, size_t count, size_t bs,
+            bool pad, Item *item) override {
+        size_t start = GetQueryPosition(samples, begin);
+        item->tensors_.resize(1);
+        if (!pad) {
+            item->tensors_[0] = GetBatchView(start, count);
+        } else {
+            ov::Shape shape = sample_shape();
+            shape[0] = bs;
+            size_t sample_bytes = ov::shape_size(shape) / bs;
+            if (item->staging_.empty() || item->staging_[0].get_shape() != shape) {
+                item->staging_.resize(1);
+                item->staging_[0] = ov::Tensor(ov::element::u8, shape);
             }
-            std::vector<mlperf::QuerySampleIndex> idxs;
-            std::vector<mlperf::ResponseId> ids;
-            for (size_t j = 0; j < (unsigned) bs; ++j) {
-                ids.push_back(query_ids[j]);
-                idxs.push_back(samples[j]);
+            for (size_t k = 0; k < bs; ++k) {
+                std::memcpy(item->staging_[0].data<unsigned char>() + k * sample_bytes,
+                        image_list_inmemory_[start + std::min(k, count - 1)].data(), sample_bytes);
             }
+            item->tensors_[0] = item->staging_[0];
+        }
+        item->set_samples(samples, query_ids, begin, count);
+    }
 
-            items.push_back(Item(input, ids, idxs));
+    void GetSamplesBatchedServer(const std::vector<mlperf::QuerySampleIndex>& samples,
+            const std::vector<mlperf::ResponseId>& query_ids, size_t bs, Item *item) {
+        ov::Shape shape = sample_shape();
+        shape[0] = bs;
+        size_t sample_bytes = ov::shape_size(shape) / bs;
+
+        if (item->staging_.empty() || item->staging_[0].get_shape() != shape) {
+            item->staging_.resize(1);
+            item->staging_[0] = ov::Tensor(ov::element::u8, shape);
+        }
+        ov::Tensor& input = item->staging_[0];
+
+        size_t num_samples = std::min(bs, samples.size());
+        for (size_t k = 0; k < bs; ++k) {
+            auto start = samples[std::min(k, num_samples - 1)];
+            std::memcpy((input.data<unsigned char>() + (k * sample_bytes)),
+                    image_list_inmemory_[start].data(), sample_bytes);
         }
+        item->tensors_.resize(1);
+        item->tensors_[0] = input;
+        item->set_samples(samples, query_ids, 0, num_samples);
     }
 
     void GetSamplesBatchedMultistream(
-            const std::vector<mlperf::QuerySampleIndex> samples,
-            std::vector<mlperf::ResponseId> query_ids, size_t bs,
+            const std::vector<mlperf::QuerySampleIndex>& samples,
+            const std::vector<mlperf::ResponseId>& query_ids, size_t bs,
             int num_batches, std::vector<Item> &items) {
-        size_t image_size = (image_height_ * image_width_);
-        ov::Shape shape { (bs), num_channels_, image_height_, image_width_ };
-
         // find sample
         std::vector<mlperf::QuerySampleIndex>::iterator it = std::find(
                 sample_list_inmemory_.begin(), sample_list_inmemory_.end(),
@@ -200,27 +318,59 @@ public:
             throw std::logic_error("Aborted");
         }
 
+        ReserveItems(items, num_batches);
         int index = std::distance(sample_list_inmemory_.begin(), it);
         auto start = index;
         auto query_start = 0;
         for (int i = 0; i < num_batches; ++i) {
-            auto input = ov::Tensor(ov::element::u8, shape, image_list_inmemory_[start].data());
-
-            std::vector<mlperf::QuerySampleIndex> idxs;
-            std::vector<mlperf::ResponseId> ids;
-            for (size_t j = (query_start); j < (unsigned) (query_start + bs);
-                    ++j) {
-                ids.push_back(query_ids[j]);
-                idxs.push_back(samples[j]);
-            }
-
-            items.push_back(Item(input, ids, idxs));
+            items[i].tensors_.resize(1);
+            items[i].tensors_[0] = GetBatchView(start, bs);
+            items[i].set_samples(samples, query_ids, query_start, bs);
 
             start = start + bs;
             query_start = query_start + bs;
         }
     }
 
+    // Copies count consecutive samples into a staged Item's input tensor
+    void CopyToStaging(const void* first, size_t count, Item *item) {
+        ov::Tensor& input = item->staging_[0];
+        size_t bytes = count * ov::shape_size(sample_shape());
+        if (bytes != input.get_byte_size()) {
+            throw std::runtime_error("Samples do not match the staged input");
+        }
+        std::memcpy(input.data(), first, bytes);
+        item->tensors_[0] = input;
+    }
+
+    // Batch tensors over the contiguous sample slab are created once per start sample
+    const ov::Tensor& GetBatchView(size_t start, size_t bs) {
+        if (batch_views_.size() < image_list_inmemory_.size()) {
+            batch_views_.resize(image_list_inmemory_.size());
+        }
+        ov::Tensor& view = batch_views_[start];
+        if (!view || view.get_shape()[0] != bs) {
+            ov::Shape shape = sample_shape();
+            shape[0] = bs;
+            view = ov::Tensor(ov::element::u8, shape, image_list_inmemory_[start].data());
+        }
+        return view;
+    }
+
+    // Stores decoded images at size x size for a graph that does the color conversion,
+    // resize and layout change itself; 0 keeps host preprocessing
+    void set_graph_preprocess(size_t size) {
+        graph_preprocess_size_ = size;
+    }
+
+    // One sample: NCHW RGB at the model size, or NHWC BGR at the intermediate size
+    ov::Shape sample_shape() const {
+        if (graph_preprocess_size_ > 0) {
+            return ov::Shape{ 1, graph_preprocess_size_, graph_preprocess_size_, num_channels_ };
+        }
+        return ov::Shape{ 1, num_channels_, image_height_, image_width_ };
+    }
+
     // Preprocessing routines
     void center_crop(cv::Mat* image, int out_height, int out_width,
             cv::Mat* cropped_image) {
@@ -281,13 +431,38 @@ public:
         resized_image.copyTo(*processed_image);
     }
 
+    // Host part of in-graph preprocessing: the only resample of the image. ResNet50's
+    // reference resizes the short side to 224 / 0.875 and crops the central 224 square; that
+    // is the same region as cropping the central 87.5% square of the decoded image first,
+    // which is then downscaled once with the reference's INTER_AREA. RetinaNet keeps its
+    // linear resize.
+    void preprocess_for_graph(cv::Mat* image, cv::Mat* processed_image) {
+        cv::Mat cropped_image = *image;
+        int interpolation = cv::INTER_LINEAR;
+        if (this->workload_name_ == mlperf_ov::WorkloadName::ResNet50) {
+            int side = int(0.875 * std::min(image->cols, image->rows));
+            center_crop(image, side, side, &cropped_image);
+            interpolation = cv::INTER_AREA;
+        }
+        cv::resize(cropped_image, *processed_image,
+                cv::Size(graph_preprocess_size_, graph_preprocess_size_), 0, 0, interpolation);
+    }
+
 public:
     std::vector<string> image_list_;
     std::vector<int> label_list_;
     std::vector<ov::Tensor> image_list_inmemory_;
+    std::vector<ov::Tensor> batch_views_;
     std::vector<std::pair<ov::Tensor, ov::Tensor>> data_list_inmemory_;
     size_t image_width_;
     size_t image_height_;
     size_t num_channels_;
     string image_format_;
+    size_t graph_preprocess_size_ = 0;
+    std::unique_ptr<PreprocessedSampleCache> sample_cache_;
+    // Bump whenever LoadImage() writes different bytes for the same image, so old sample
+    // cache files stop matching
+    static constexpr int kPreprocessVersion = 2;
 };
+
+constexpr int ImageDataset::kPreprocessVersion;
@@ -7,6 +7,8 @@
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/foreach.hpp>
 
+#include <map>
+
 #include "image_dataset.h"
 
 class OpenImages: public ImageDataset {
@@ -53,12 +55,28 @@ public:
             }
         }
         ifs.close();
+        LoadGroundTruth(pt);
 
         if (!image_list_.size()) {
             std::cout << "No images in image list found";
         }
     }
 
+    /// @brief Annotated box of a sample, normalized like the post-processed detections.
+    struct GroundTruthBox {
+        int category;
+        float ymin, xmin, ymax, xmax;
+    };
+
+    // Annotations of the accuracy subset, for PrecisionAB's mAP
+    bool HasGroundTruth() const {
+        return !ground_truth_.empty();
+    }
+
+    const std::vector<GroundTruthBox>& GetGroundTruth(mlperf::QuerySampleIndex sample) const {
+        return ground_truth_.at(sample);
+    }
+
     const std::string& Name() override {
         static const std::string name("OpenVINO OpenImages v6 QSL");
         return name;
@@ -66,6 +84,51 @@ public:
 
     ~OpenImages() {}
 private:
+    // COCO boxes are [x, y, width, height] in image pixels; detections are [0, 1] corners.
+    // Category ids are the model's labels, as the accuracy script reads them. Crowd boxes
+    // are left out.
+    void LoadGroundTruth(const boost::property_tree::ptree& pt) {
+        auto annotations = pt.get_child_optional("annotations");
+        if (!annotations) {
+            return;
+        }
+        struct ImageInfo {
+            size_t sample;
+            float width, height;
+        };
+        std::map<int, ImageInfo> images;
+        size_t sample = 0;
+        for (const auto& image : pt.get_child("images")) {
+            if (sample >= image_list_.size()) {
+                break;
+            }
+            images[image.second.get<int>("id")] = { sample++, image.second.get<float>("width"),
+                                                    image.second.get<float>("height") };
+        }
+        ground_truth_.resize(image_list_.size());
+        for (const auto& annotation : *annotations) {
+            auto it = images.find(annotation.second.get<int>("image_id"));
+            if (it == images.end() || annotation.second.get<int>("iscrowd", 0) != 0) {
+                continue;
+            }
+            float bbox[4];
+            size_t k = 0;
+            for (const auto& value : annotation.second.get_child("bbox")) {
+                if (k < 4) {
+                    bbox[k++] = value.second.get_value<float>();
+                }
+            }
+            if (k < 4) {
+                continue;
+            }
+            const ImageInfo& info = it->second;
+            ground_truth_[info.sample].push_back({ annotation.second.get<int>("category_id"),
+                    bbox[1] / info.height, bbox[0] / info.width,
+                    (bbox[1] + bbox[3]) / info.height, (bbox[0] + bbox[2]) / info.width });
+        }
+    }
+
+    std::vector<std::vector<GroundTruthBox>> ground_truth_;
     std::vector<int> ids_;
     std::vector<cv::Size> sizes_;
 };
\ No newline at end of file
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <unistd.h>
+
+/// @brief On-disk cache of preprocessed samples, memory-mapped read-write.
+///
+/// One file has a slot for every sample of a dataset in sample-index order, exactly as
+/// the QSL would write it to RAM, after a fixed-size header and a table of filled slots.
+/// The file is created sparse and slots are filled as samples are first loaded, so a run
+/// only preprocesses the samples it uses. The key hashes a description of everything that
+/// changes those bytes (dataset, workload, sample shape, preprocessing version and the
+/// sample list), so a stale file is never read. The page cache keeps filled samples warm
+/// across runs and shares them between processes.
+class PreprocessedSampleCache final {
+public:
+    explicit PreprocessedSampleCache(const std::string& cache_dir) : cache_dir_(cache_dir) {
+        boost::filesystem::create_directories(cache_dir_);
+    }
+
+    ~PreprocessedSampleCache() {
+        try {
+            flush();
+        } catch (const std::exception& e) {
+            std::cout << "    [WARNING] Sample cache could not be flushed: " << e.what() << std::endl;
+        }
+    }
+
+    PreprocessedSampleCache(const PreprocessedSampleCache&) = delete;
+    PreprocessedSampleCache& operator=(const PreprocessedSampleCache&) = delete;
+
+    /// Builds the cache key from a readable prefix and a description of the preprocessing.
+    std::string make_key(const std::string& prefix, const std::string& description) const {
+        uint64_t hash = kFnvOffset;
+        for (unsigned char c : description) {
+            hash = (hash ^ c) * kFnvPrime;
+        }
+        std::stringstream key;
+        key << prefix << "_" << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return key.str();
+    }
+
+    /// Maps the cache file of a key, creating an empty one on a miss or over a file of another
+    /// layout. Returns false when the file cannot be created or mapped; caching is then off.
+    bool open(const std::string& key, size_t num_samples, size_t sample_bytes) {
+        std::string path = file_path(key);
+        size_t data_offset = sizeof(Header) + round_up(num_samples, kAlign);
+        size_t file_size = data_offset + num_samples * sample_bytes;
+        try {
+            if (!boost::filesystem::exists(path)) {
+                std::cout << "    [INFO] Sample cache miss: " << key << ", creating it" << std::endl;
+                create(path, num_samples, sample_bytes, file_size);
+            }
+            map(path);
+            if (!matches(num_samples, sample_bytes, file_size)) {
+                // Left by an older layout; its samples cannot be reused
+                std::cout << "    [WARNING] Sample cache entry " << key << " has another layout, recreating it" << std::endl;
+                region_ = boost::interprocess::mapped_region();
+                boost::filesystem::remove(path);
+                create(path, num_samples, sample_bytes, file_size);
+                map(path);
+            }
+        } catch (const std::exception& e) {
+            std::cout << "    [WARNING] Sample cache entry " << key << " could not be opened: " << e.what() << std::endl;
+            region_ = boost::interprocess::mapped_region();
+            return false;
+        }
+        num_samples_ = num_samples;
+        sample_bytes_ = sample_bytes;
+        data_offset_ = data_offset;
+        std::cout << "    [INFO] Sample cache mapped: " << key << ", " << num_filled() << " of "
+                  << num_samples << " samples filled" << std::endl;
+        return true;
+    }
+
+    bool is_open() const {
+        return region_.get_address() != nullptr;
+    }
+
+    /// Whether sample index holds preprocessed bytes. Concurrent runs may fill the same
+    /// slot twice; both write identical bytes.
+    bool filled(size_t index) const {
+        return filled_table()[index] != 0;
+    }
+
+    /// Marks a slot filled once its bytes have been written through sample(); the fence keeps
+    /// the mark behind the bytes for other processes mapping the file.
+    void set_filled(size_t index) {
+        std::atomic_thread_fence(std::memory_order_release);
+        filled_table()[index] = 1;
+    }
+
+    unsigned char* sample(size_t index) const {
+        return static_cast<unsigned char*>(region_.get_address()) + data_offset_ + index * sample_bytes_;
+    }
+
+    /// Writes the mapped pages back to the file and waits for it. Flushing filled samples
+    /// before marking them keeps a crash from leaving marked slots without their bytes.
+    void flush() {
+        if (is_open() && !region_.flush(0, 0, false)) {
+            throw std::runtime_error("msync failed");
+        }
+    }
+
+private:
+    static constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+    static constexpr uint64_t kFnvPrime = 1099511628211ull;
+    static constexpr char kMagic[8] = {'O', 'V', 'S', 'M', 'P', 'L', '0', '2'};
+    static constexpr size_t kAlign = 64;
+
+    // Padded so the filled-slot table, and after it the sample data, start cache-line aligned
+    struct Header {
+        char magic[8];
+        uint64_t num_samples;
+        uint64_t sample_bytes;
+        char reserved[40];
+    };
+    static_assert(sizeof(Header) == 64, "Sample cache header must stay 64 bytes");
+
+    static size_t round_up(size_t value, size_t align) {
+        return (value + align - 1) / align * align;
+    }
+
+    // Writes the header and extends the file to its full size without writing the slots, so
+    // the file system keeps it sparse until samples are filled. Renamed last so concurrent
+    // runs never map a file without its header. The temporary name is unique per process, and
+    // a file another run published meanwhile is kept, since it may already hold samples.
+    static void create(const std::string& path, size_t num_samples, size_t sample_bytes, size_t file_size) {
+        std::string tmp_path = path + "." + std::to_string(getpid()) + "." +
+                               boost::filesystem::unique_path("%%%%%%%%").string() + ".tmp";
+        try {
+            {
+                std::ofstream file(tmp_path, std::ios::binary);
+                Header header{};
+                std::memcpy(header.magic, kMagic, sizeof(kMagic));
+                header.num_samples = num_samples;
+                header.sample_bytes = sample_bytes;
+                file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                if (!file) {
+                    throw std::runtime_error("write failed");
+                }
+            }
+            boost::filesystem::resize_file(tmp_path, file_size);
+            boost::system::error_code error;
+            boost::filesystem::create_hard_link(tmp_path, path, error);
+            if (error && !boost::filesystem::exists(path)) {
+                // File systems without hard links; a concurrent creator may still win here
+                boost::filesystem::rename(tmp_path, path);
+            }
+            std::remove(tmp_path.c_str());
+        } catch (...) {
+            std::remove(tmp_path.c_str());
+            throw;
+        }
+    }
+
+    void map(const std::string& path) {
+        boost::interprocess::file_mapping file(path.c_str(), boost::interprocess::read_write);
+        region_ = boost::interprocess::mapped_region(file, boost::interprocess::read_write);
+    }
+
+    bool matches(size_t num_samples, size_t sample_bytes, size_t file_size) const {
+        Header header{};
+        std::memcpy(&header, region_.get_address(), std::min(sizeof(header), region_.get_size()));
+        return region_.get_size() == file_size && std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+               header.num_samples == num_samples && header.sample_bytes == sample_bytes;
+    }
+
+    unsigned char* filled_table() const {
+        return static_cast<unsigned char*>(region_.get_address()) + sizeof(Header);
+    }
+
+    size_t num_filled() const {
+        size_t count = 0;
+        for (size_t i = 0; i < num_samples_; ++i) {
+            count += filled(i);
+        }
+        return count;
+    }
+
+    std::string file_path(const std::string& key) const {
+        return (boost::filesystem::path(cache_dir_) / (key + ".samples")).string();
+    }
+
+    std::string cache_dir_;
+    boost::interprocess::mapped_region region_;
+    size_t num_samples_ = 0;
+    size_t sample_bytes_ = 0;
+    size_t data_offset_ = 0;
+};
+
+constexpr uint64_t PreprocessedSampleCache::kFnvOffset;
+constexpr uint64_t PreprocessedSampleCache::kFnvPrime;
+constexpr char PreprocessedSampleCache::kMagic[8];
+constexpr size_t PreprocessedSampleCache::kAlign;
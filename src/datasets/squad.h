@@ -63,6 +63,23 @@ public:
                                 sample_segment_ids_);
                         sample_segment_ids_.clear();
                     }
+                    if (prop.first == "tokens") {
+                        std::vector<std::string> tokens;
+                        for (auto& vs : prop.second) {
+                            tokens.push_back(vs.second.data());
+                        }
+                        this->squad_tokens_.push_back(tokens);
+                    }
+                    if (prop.first == "answers") {
+                        std::vector<std::string> answers;
+                        for (auto& vs : prop.second) {
+                            answers.push_back(vs.second.data());
+                        }
+                        this->squad_answers_.push_back(answers);
+                    }
+                    if (prop.first == "example_index") {
+                        this->example_indices_.push_back(prop.second.get_value<size_t>());
+                    }
                     if (prop.first == "input_mask") {
                         boost::property_tree::ptree subtree = (boost::property_tree::ptree) prop.second ;
                         BOOST_FOREACH(boost::property_tree::ptree::value_type &vs,
@@ -71,6 +88,9 @@ public:
                         }
                         this->squad_input_mask_.push_back(
                                 sample_input_mask_);
+                        // Real tokens form the masked prefix of each feature
+                        this->seq_lengths_.push_back(
+                                std::count(sample_input_mask_.begin(), sample_input_mask_.end(), 1));
                         sample_input_mask_.clear();
                     }
                     if (total_count_
@@ -123,87 +143,149 @@ public:
             }
         }
 
-        mlperf::QuerySampleIndex sample;
-
-        for (uint i = 0; i < samples.size(); ++i) {
-            sample = samples[i];
-
-            ov::Shape shape{1, max_seq_length_};
-            ov::Tensor m_inp0 = ov::Tensor(ov::element::i32, shape);
-            ov::Tensor m_inp1 = ov::Tensor(ov::element::i32, shape);
-            ov::Tensor m_inp2 = ov::Tensor(ov::element::i32, shape);
-
-            for (size_t j = 0; j < max_seq_length_; j++){
-                m_inp0.data<int32_t>()[j] = static_cast<int32_t>(squad_input_ids_.at(sample).at(j));
-                m_inp1.data<int32_t>()[j] = static_cast<int32_t>(squad_input_mask_.at(sample).at(j));
-                m_inp2.data<int32_t>()[j] = static_cast<int32_t>(squad_segment_ids_.at(sample).at(j));
-            }
+        // Samples live in one slab per input so Offline/MultiStream batches can be
+        // zero-copy views over consecutive samples
+        ov::Shape slab_shape{samples.size(), max_seq_length_};
+        slab_rows_.resize(squad_input_ids_.size());
+        input_ids_slab_ = ov::Tensor(ov::element::i32, slab_shape);
+        input_mask_slab_ = ov::Tensor(ov::element::i32, slab_shape);
+        segment_ids_slab_ = ov::Tensor(ov::element::i32, slab_shape);
+
+        ForEachShard(samples.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                mlperf::QuerySampleIndex sample = samples[i];
+                slab_rows_[sample] = i;
+
+                ov::Shape shape{1, max_seq_length_};
+                size_t offset = i * max_seq_length_;
+                ov::Tensor m_inp0 = ov::Tensor(ov::element::i32, shape, input_ids_slab_.data<int32_t>() + offset);
+                ov::Tensor m_inp1 = ov::Tensor(ov::element::i32, shape, input_mask_slab_.data<int32_t>() + offset);
+                ov::Tensor m_inp2 = ov::Tensor(ov::element::i32, shape, segment_ids_slab_.data<int32_t>() + offset);
+
+                for (size_t j = 0; j < max_seq_length_; j++){
+                    m_inp0.data<int32_t>()[j] = static_cast<int32_t>(squad_input_ids_.at(sample).at(j));
+                    m_inp1.data<int32_t>()[j] = static_cast<int32_t>(squad_input_mask_.at(sample).at(j));
+                    m_inp2.data<int32_t>()[j] = static_cast<int32_t>(squad_segment_ids_.at(sample).at(j));
+                }
 
-            if (settings_.scenario == mlperf::TestScenario::Offline) {
-                input_ids_inmemory_[i] = m_inp0;
-                input_mask_inmemory_[i] = m_inp1;
-		        segment_ids_inmemory_[i] = m_inp2;
-            } else if ((settings_.scenario == mlperf::TestScenario::SingleStream)
-                    || (settings_.scenario == mlperf::TestScenario::Server)) {
-                input_ids_inmemory_[sample] = m_inp0;
-                input_mask_inmemory_[sample] = m_inp1;
-                segment_ids_inmemory_[sample] = m_inp2;
-            } else if (this->settings_.scenario == mlperf::TestScenario::MultiStream) {
-                input_ids_inmemory_[i] = m_inp0;
-                input_mask_inmemory_[i] = m_inp1;
-                segment_ids_inmemory_[i] = m_inp2;
-                sample_list_inmemory_[i] = sample;
+                if (settings_.scenario == mlperf::TestScenario::Offline) {
+                    input_ids_inmemory_[i] = m_inp0;
+                    input_mask_inmemory_[i] = m_inp1;
+                    segment_ids_inmemory_[i] = m_inp2;
+                } else if ((settings_.scenario == mlperf::TestScenario::SingleStream)
+                        || (settings_.scenario == mlperf::TestScenario::Server)) {
+                    input_ids_inmemory_[sample] = m_inp0;
+                    input_mask_inmemory_[sample] = m_inp1;
+                    segment_ids_inmemory_[sample] = m_inp2;
+                } else if (this->settings_.scenario == mlperf::TestScenario::MultiStream) {
+                    input_ids_inmemory_[i] = m_inp0;
+                    input_mask_inmemory_[i] = m_inp1;
+                    segment_ids_inmemory_[i] = m_inp2;
+                    sample_list_inmemory_[i] = sample;
+                }
             }
-        }
+        });
     }
 
     void UnloadSamplesFromRam(const std::vector<mlperf::QuerySampleIndex>& samples) override {
+        this->batch_views_.clear();
         this->segment_ids_inmemory_.clear();
         this->input_ids_inmemory_.clear();
         this->input_mask_inmemory_.clear();
+        this->input_ids_slab_ = ov::Tensor();
+        this->input_mask_slab_ = ov::Tensor();
+        this->segment_ids_slab_ = ov::Tensor();
     }
 
-    void GetSample(const std::vector<mlperf::QuerySampleIndex> samples,
-            std::vector<mlperf::ResponseId> query_ids, size_t bs, Item *item) {
-         std::vector<ov::Tensor> input;
-         input.push_back(input_ids_inmemory_[samples[0]]);
-         input.push_back(input_mask_inmemory_[samples[0]]);
-         input.push_back(segment_ids_inmemory_[samples[0]]);
-             *item = Item(input, query_ids, samples);
-     }
-
-    void GetSamplesBatched(const std::vector<mlperf::QuerySampleIndex> samples,
-            std::vector<mlperf::ResponseId> query_ids, size_t bs, int num_batches, std::vector<Item> &items) {
-        ov::Shape shape{bs, max_seq_length_};
-
-        for (int i = 0; i < num_batches; ++i) {
-            auto start = (i * bs) % perf_count_;
+    void GetSample(const std::vector<mlperf::QuerySampleIndex>& samples,
+            const std::vector<mlperf::ResponseId>& query_ids, size_t bs, Item *item) {
+        if (item->staged_) {
+            CopyToStaging(samples[0], 1, item);
+        } else {
+            item->tensors_.resize(3);
+            item->tensors_[0] = input_ids_inmemory_[samples[0]];
+            item->tensors_[1] = input_mask_inmemory_[samples[0]];
+            item->tensors_[2] = segment_ids_inmemory_[samples[0]];
+        }
+        item->set_samples(samples, query_ids, 0, samples.size());
+    }
 
-            ov::Tensor input_ids = ov::Tensor(ov::element::i32, shape, input_ids_inmemory_[start].data<int32_t>());
-            ov::Tensor input_mask = ov::Tensor(ov::element::i32, shape, input_mask_inmemory_[start].data<int32_t>());
-            ov::Tensor segment_ids = ov::Tensor(ov::element::i32, shape, segment_ids_inmemory_[start].data<int32_t>());
+    void GetSamplesBatch(const std::vector<mlperf::QuerySampleIndex>& samples,
+            const std::vector<mlperf::ResponseId>& query_ids, size_t bs, size_t batch_idx, Item *item) {
+        auto start = (batch_idx * bs) % perf_count_;
+        if (item->staged_) {
+            CopyToStaging(start, bs, item);
+        } else {
+            SetBatchView(start, bs, item);
+        }
+        item->set_samples(samples, query_ids, batch_idx * bs, bs);
+    }
 
-            std::vector<ov::Tensor> inputs {input_ids, input_mask, segment_ids};
+    void GetSamplesTail(const std::vector<mlperf::QuerySampleIndex>& samples,
+        const std::vector<mlperf::ResponseId>& query_ids, size_t begin, size_t count, size_t bs,
+        bool pad, Item *item) override {
+        size_t start = GetQueryPosition(samples, begin);
+        if (!pad) {
+            SetBatchView(start, count, item);
+        } else {
+            ov::Shape shape{bs, max_seq_length_};
+            size_t sample_bytes = max_seq_length_ * sizeof(int32_t);
+            if (item->staging_.size() < 3 || item->staging_[0].get_shape() != shape) {
+                item->staging_.resize(std::max<size_t>(item->staging_.size(), 3));
+                for (size_t j = 0; j < 3; ++j) {
+                    item->staging_[j] = ov::Tensor(ov::element::i32, shape);
+                }
+            }
+            const std::vector<ov::Tensor>* inputs[3] = { &input_ids_inmemory_, &input_mask_inmemory_,
+                                                         &segment_ids_inmemory_ };
+            for (size_t k = 0; k < bs; ++k) {
+                size_t position = start + std::min(k, count - 1);
+                for (size_t j = 0; j < 3; ++j) {
+                    std::memcpy(item->staging_[j].data<int32_t>() + k * max_seq_length_,
+                            (*inputs[j])[position].data<int32_t>(), sample_bytes);
+                }
+            }
+            item->tensors_.resize(3);
+            for (size_t j = 0; j < 3; ++j) {
+                item->tensors_[j] = item->staging_[j];
+            }
+        }
+        item->set_samples(samples, query_ids, begin, count);
+    }
 
-            std::vector<mlperf::QuerySampleIndex> idxs;
-            std::vector<mlperf::ResponseId> ids;
+    void GetSamplesBatchedServer(const std::vector<mlperf::QuerySampleIndex>& samples,
+        const std::vector<mlperf::ResponseId>& query_ids, size_t bs, Item *item) {
+        ov::Shape shape{bs, max_seq_length_};
+        size_t sample_bytes = max_seq_length_ * sizeof(int32_t);
 
-            for (size_t j = (i * bs); j < (unsigned) ((i * bs) + bs); ++j) {
-                ids.push_back(query_ids[j]);
-                idxs.push_back(samples[j]);
+        if (item->staging_.size() != 3 || item->staging_[0].get_shape() != shape) {
+            item->staging_.resize(3);
+            for (auto& tensor : item->staging_) {
+                tensor = ov::Tensor(ov::element::i32, shape);
             }
+        }
 
-            items.push_back(Item(inputs, ids, idxs));
+        // Partial batches are padded with the last sample; only real samples get response ids
+        size_t num_samples = std::min(bs, samples.size());
+        for (size_t k = 0; k < bs; ++k) {
+            auto sample = samples[std::min(k, num_samples - 1)];
+            std::memcpy(item->staging_[0].data<int32_t>() + k * max_seq_length_,
+                    input_ids_inmemory_[sample].data<int32_t>(), sample_bytes);
+            std::memcpy(item->staging_[1].data<int32_t>() + k * max_seq_length_,
+                    input_mask_inmemory_[sample].data<int32_t>(), sample_bytes);
+            std::memcpy(item->staging_[2].data<int32_t>() + k * max_seq_length_,
+                    segment_ids_inmemory_[sample].data<int32_t>(), sample_bytes);
         }
+
+        item->tensors_.resize(3);
+        for (size_t k = 0; k < 3; ++k) {
+            item->tensors_[k] = item->staging_[k];
+        }
+        item->set_samples(samples, query_ids, 0, num_samples);
     }
-    void GetSamplesBatchedServer(const std::vector<mlperf::QuerySampleIndex> samples,
-        std::vector<mlperf::ResponseId> query_ids, size_t bs, int num_batches, std::vector<Item> &items) {
-            throw std::runtime_error("GetSamplesBatchedServer is not implemented!");
-    }
-    void GetSamplesBatchedMultistream(const std::vector<mlperf::QuerySampleIndex> samples,
-        std::vector<mlperf::ResponseId> query_ids, size_t bs, int num_batches, std::vector<Item> &items) {
-        ov::Shape shape{bs, max_seq_length_};
 
+    void GetSamplesBatchedMultistream(const std::vector<mlperf::QuerySampleIndex>& samples,
+        const std::vector<mlperf::ResponseId>& query_ids, size_t bs, int num_batches, std::vector<Item> &items) {
         std::vector<mlperf::QuerySampleIndex>::iterator it = std::find(
                 sample_list_inmemory_.begin(), sample_list_inmemory_.end(),
                 samples[0]);
@@ -212,31 +294,129 @@ public:
             throw std::logic_error("Aborted");
         }
 
+        ReserveItems(items, num_batches);
         int index = std::distance(sample_list_inmemory_.begin(), it);
         auto start = index;
         auto query_start = 0;
         for (int i = 0; i < num_batches; ++i) {
-            ov::Tensor input_ids = ov::Tensor(ov::element::i32, shape, input_ids_inmemory_[start].data<int32_t>());
-            ov::Tensor input_mask = ov::Tensor(ov::element::i32, shape, input_mask_inmemory_[start].data<int32_t>());
-            ov::Tensor segment_ids = ov::Tensor(ov::element::i32, shape, segment_ids_inmemory_[start].data<int32_t>());
-
-            std::vector<ov::Tensor> inputs {input_ids, input_mask, segment_ids};
-
-            std::vector<mlperf::QuerySampleIndex> idxs;
-            std::vector<mlperf::ResponseId> ids;
-            for (size_t j = (query_start); j < (unsigned) (query_start + bs);
-                    ++j) {
-                ids.push_back(query_ids[j]);
-                idxs.push_back(samples[j]);
-            }
-
-            items.push_back(Item(inputs, ids, idxs));
+            SetBatchView(start, bs, &items[i]);
+            items[i].set_samples(samples, query_ids, query_start, bs);
 
             start = start + bs;
             query_start = query_start + bs;
         }
     }
 
+    size_t GetSampleLength(mlperf::QuerySampleIndex sample) override {
+        return seq_lengths_.at(sample);
+    }
+
+    void GetSamplesBucket(const std::vector<mlperf::QuerySampleIndex>& samples,
+        const std::vector<mlperf::ResponseId>& query_ids, size_t begin, size_t count, size_t bs,
+        size_t bucket, size_t seq_len, Item *item) override {
+        // Each bucket keeps its own staging tensors so steady-state batches do not allocate
+        ov::Shape shape{bs, seq_len};
+        size_t first = bucket * 3;
+        if (item->staging_.size() < first + 3) {
+            item->staging_.resize(first + 3);
+        }
+        if (!item->staging_[first] || item->staging_[first].get_shape() != shape) {
+            for (size_t k = first; k < first + 3; ++k) {
+                item->staging_[k] = ov::Tensor(ov::element::i32, shape);
+            }
+        }
+
+        const int32_t* slabs[3] = { input_ids_slab_.data<int32_t>(), input_mask_slab_.data<int32_t>(),
+                                    segment_ids_slab_.data<int32_t>() };
+        size_t sample_bytes = seq_len * sizeof(int32_t);
+        for (size_t k = 0; k < bs; ++k) {
+            auto sample = samples[begin + std::min(k, count - 1)];
+            size_t offset = slab_rows_[sample] * max_seq_length_;
+            for (size_t j = 0; j < 3; ++j) {
+                std::memcpy(item->staging_[first + j].data<int32_t>() + k * seq_len, slabs[j] + offset, sample_bytes);
+            }
+        }
+
+        item->tensors_.resize(3);
+        for (size_t k = 0; k < 3; ++k) {
+            item->tensors_[k] = item->staging_[first + k];
+        }
+        item->set_samples(samples, query_ids, begin, count);
+    }
+
+    // Copies count consecutive samples from position start into a staged Item's inputs
+    void CopyToStaging(size_t start, size_t count, Item *item) {
+        const std::vector<ov::Tensor>* inputs[3] = { &input_ids_inmemory_, &input_mask_inmemory_,
+                                                     &segment_ids_inmemory_ };
+        size_t bytes = count * max_seq_length_ * sizeof(int32_t);
+        item->tensors_.resize(3);
+        for (size_t j = 0; j < 3; ++j) {
+            ov::Tensor& input = item->staging_[j];
+            if (bytes != input.get_byte_size()) {
+                throw std::runtime_error("Samples do not match the staged input");
+            }
+            std::memcpy(input.data(), (*inputs[j])[start].data(), bytes);
+            item->tensors_[j] = input;
+        }
+    }
+
+    // Batch views over the sample slabs are created once per start sample
+    void SetBatchView(size_t start, size_t bs, Item *item) {
+        if (batch_views_.size() < input_ids_inmemory_.size()) {
+            batch_views_.resize(input_ids_inmemory_.size());
+        }
+        std::vector<ov::Tensor>& views = batch_views_[start];
+        if (views.empty() || views[0].get_shape()[0] != bs) {
+            ov::Shape shape{bs, max_seq_length_};
+            views = {
+                ov::Tensor(ov::element::i32, shape, input_ids_inmemory_[start].data<int32_t>()),
+                ov::Tensor(ov::element::i32, shape, input_mask_inmemory_[start].data<int32_t>()),
+                ov::Tensor(ov::element::i32, shape, segment_ids_inmemory_[start].data<int32_t>())
+            };
+        }
+        item->tensors_.resize(3);
+        for (size_t k = 0; k < 3; ++k) {
+            item->tensors_[k] = views[k];
+        }
+    }
+
+    // Ground truth for SQuAD F1; files preprocessed before answers were exported lack it, and
+    // answer spans can only be turned back into text from vocabulary tokens
+    bool HasAnswers() const {
+        size_t count = squad_input_ids_.size();
+        return squad_answers_.size() >= count && example_indices_.size() >= count && HasVocabTokens();
+    }
+
+    // squad.py without vocabulary support exports token ids where the WordPiece strings go
+    bool HasVocabTokens() const {
+        if (squad_tokens_.size() < squad_input_ids_.size()) {
+            return false;
+        }
+        for (const auto& tokens : squad_tokens_) {
+            if (tokens.empty() || tokens[0] != "[CLS]") {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const std::vector<std::string>& GetTokens(mlperf::QuerySampleIndex sample) const {
+        return squad_tokens_.at(sample);
+    }
+
+    const std::vector<std::string>& GetAnswers(mlperf::QuerySampleIndex sample) const {
+        return squad_answers_.at(sample);
+    }
+
+    // SQuAD question a feature (document span) belongs to
+    size_t GetExampleIndex(mlperf::QuerySampleIndex sample) const {
+        return example_indices_.at(sample);
+    }
+
+    const std::vector<int>& GetSegmentIds(mlperf::QuerySampleIndex sample) const {
+        return squad_segment_ids_.at(sample);
+    }
+
     const std::string& Name() override {
         static const std::string name("OpenVINO Squad v1.1 QSL");
         return name;
@@ -251,7 +431,16 @@ private:
     std::vector<std::vector<int>> squad_input_mask_;
     std::vector<std::vector<int>> squad_segment_ids_;
     std::vector<std::vector<string>> squad_tokens_;
+    std::vector<std::vector<string>> squad_answers_;
+    std::vector<size_t> example_indices_;
+    std::vector<size_t> seq_lengths_;
+    // Slab row of every loaded sample
+    std::vector<size_t> slab_rows_;
     std::vector<ov::Tensor> input_ids_inmemory_;
     std::vector<ov::Tensor> input_mask_inmemory_;
     std::vector<ov::Tensor> segment_ids_inmemory_;
+    ov::Tensor input_ids_slab_;
+    ov::Tensor input_mask_slab_;
+    ov::Tensor segment_ids_slab_;
+    std::vector<std::vector<ov::Tensor>> batch_views_;
 };
\ No newline at end of file
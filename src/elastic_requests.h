@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct ElasticRequestsProperties {
+    // Bounds of the number of infer requests in service
+    size_t min_requests = 1;
+    size_t max_requests = 1;
+    // Time between two resizing decisions
+    unsigned interval_ms = 100;
+    // Grow when more than this share of request acquisitions found every request busy
+    double grow_blocked_share = 0.05;
+    // Shrink when no acquisition waited and fewer than this share of requests were busy
+    double shrink_utilization = 0.5;
+};
+
+/// @brief Resizes a Server request queue between bounds while the test runs.
+///
+/// Requests that dispatchers had to wait for mean the pool is too small for the
+/// load, so it grows by one. A pool that never made a dispatcher wait and whose
+/// requests were mostly idle shrinks by one, which takes contention off the
+/// device streams. Utilization is sampled twenty times per interval. Every
+/// decision is recorded and printed by report().
+template <typename Queue>
+class ElasticRequests final {
+public:
+    ElasticRequests(Queue& queue, const ElasticRequestsProperties& properties, size_t initial_requests) :
+            queue_(queue),
+            properties_(properties),
+            initial_requests_(std::min(std::max(initial_requests, properties.min_requests), properties.max_requests)) {}
+
+    ~ElasticRequests() {
+        stop();
+    }
+
+    ElasticRequests(const ElasticRequests&) = delete;
+    ElasticRequests& operator=(const ElasticRequests&) = delete;
+
+    /// Shrinks the queue to the initial size and starts resizing; later calls do nothing.
+    void start() {
+        if (controller_.joinable()) {
+            return;
+        }
+        start_ = std::chrono::steady_clock::now();
+        decisions_.push_back(Decision{0, queue_.target_requests(), initial_requests_, 0, 0, 0});
+        queue_.set_target_requests(initial_requests_);
+        controller_ = std::thread(&ElasticRequests::Control, this);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+        if (controller_.joinable()) {
+            controller_.join();
+        }
+    }
+
+    void report() const {
+        if (decisions_.empty()) {
+            return;
+        }
+        std::cout << "    [INFO] Elastic infer requests (" << properties_.min_requests << ".."
+                  << properties_.max_requests << ", every " << properties_.interval_ms << " ms): "
+                  << decisions_.size() - 1 << " resizes, " << queue_.target_requests() << " at the end" << std::endl;
+        for (const auto& decision : decisions_) {
+            std::cout << "         " << std::fixed << std::setprecision(1) << std::setw(9) << decision.time_ms
+                      << " ms: " << decision.from << " -> " << decision.to;
+            if (decision.time_ms > 0) {
+                std::cout << " (" << std::setprecision(1) << 100 * decision.blocked_share
+                          << "% acquisitions waited, " << std::setprecision(2) << decision.wait_us
+                          << " us mean wait, " << std::setprecision(1) << 100 * decision.utilization << "% busy)";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+private:
+    struct Decision {
+        double time_ms;
+        size_t from;
+        size_t to;
+        double blocked_share;
+        double wait_us;
+        double utilization;
+    };
+
+    void Control() {
+        auto interval = std::chrono::milliseconds(properties_.interval_ms);
+        auto sample_period = std::max<std::chrono::microseconds>(interval / 20, std::chrono::microseconds(100));
+        auto next_decision = std::chrono::steady_clock::now() + interval;
+        uint64_t last_acquires = queue_.acquires();
+        uint64_t last_blocked = queue_.blocked_acquires();
+        uint64_t last_wait_ns = queue_.blocked_wait_ns();
+        size_t busy = 0, in_service = 0;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!cv_.wait_for(lock, sample_period, [this] { return stopped_; })) {
+            busy += queue_.busy_requests();
+            in_service += queue_.requests_in_service();
+            auto now = std::chrono::steady_clock::now();
+            if (now < next_decision) {
+                continue;
+            }
+            next_decision = now + interval;
+
+            uint64_t acquires = queue_.acquires() - last_acquires;
+            uint64_t blocked = queue_.blocked_acquires() - last_blocked;
+            uint64_t wait_ns = queue_.blocked_wait_ns() - last_wait_ns;
+            last_acquires += acquires;
+            last_blocked += blocked;
+            last_wait_ns += wait_ns;
+            double blocked_share = acquires == 0 ? 0.0 : static_cast<double>(blocked) / acquires;
+            double utilization = in_service == 0 ? 0.0 : static_cast<double>(busy) / in_service;
+            busy = in_service = 0;
+
+            size_t current = queue_.target_requests();
+            size_t next = current;
+            if (blocked_share > properties_.grow_blocked_share && current < properties_.max_requests) {
+                next = current + 1;
+            } else if (blocked == 0 && utilization < properties_.shrink_utilization &&
+                       current > properties_.min_requests) {
+                next = current - 1;
+            }
+            if (next != current) {
+                queue_.set_target_requests(next);
+                decisions_.push_back(Decision{
+                        std::chrono::duration<double, std::milli>(now - start_).count(), current, next, blocked_share,
+                        blocked == 0 ? 0.0 : wait_ns / 1000.0 / blocked, utilization});
+            }
+        }
+    }
+
+    Queue& queue_;
+    ElasticRequestsProperties properties_;
+    size_t initial_requests_;
+    std::chrono::steady_clock::time_point start_;
+    std::vector<Decision> decisions_;
+    std::thread controller_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopped_ = false;
+};
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/// @brief Bounded lock-free pool of idle infer request ids.
+///
+/// Ids are kept on a Treiber stack so the most recently returned request is
+/// handed out first while its buffers are still warm in cache. The head is a
+/// 64-bit word holding the top index and an ABA tag. Consumers spin for a short
+/// while before parking on a condition variable; producers only touch the mutex
+/// when somebody is actually parked.
+class IdleRequestsPool final {
+public:
+    explicit IdleRequestsPool(size_t capacity, size_t spin_iterations = 4096) :
+            next_(new std::atomic<uint32_t>[capacity]),
+            capacity_(capacity),
+            spin_iterations_(spin_iterations),
+            head_(pack(kEmpty, 0)),
+            idle_count_(0),
+            waiters_(0),
+            has_exception_(false) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            next_[i].store(kEmpty, std::memory_order_relaxed);
+        }
+    }
+
+    ~IdleRequestsPool() = default;
+
+    IdleRequestsPool(const IdleRequestsPool&) = delete;
+    IdleRequestsPool& operator=(const IdleRequestsPool&) = delete;
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    size_t idle_count() const {
+        return idle_count_.load(std::memory_order_acquire);
+    }
+
+    /// Returns a request id to the pool and wakes a parked consumer, if any.
+    void push(size_t id) {
+        uint64_t old_head = head_.load(std::memory_order_relaxed);
+        uint64_t new_head;
+        do {
+            next_[id].store(index_of(old_head), std::memory_order_relaxed);
+            new_head = pack(static_cast<uint32_t>(id), tag_of(old_head) + 1);
+        } while (!head_.compare_exchange_weak(old_head, new_head,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed));
+        idle_count_.fetch_add(1, std::memory_order_seq_cst);
+        wake_waiters();
+    }
+
+    /// Non-blocking pop. Returns false if no request is idle.
+    bool try_pop(size_t& id) {
+        uint64_t old_head = head_.load(std::memory_order_seq_cst);
+        while (index_of(old_head) != kEmpty) {
+            uint32_t top = index_of(old_head);
+            uint64_t new_head = pack(next_[top].load(std::memory_order_relaxed), tag_of(old_head) + 1);
+            if (head_.compare_exchange_weak(old_head, new_head,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_seq_cst)) {
+                idle_count_.fetch_sub(1, std::memory_order_seq_cst);
+                id = top;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Blocking pop. Spins first, then parks. Rethrows a stored inference error.
+    size_t pop() {
+        size_t id = 0;
+        for (size_t i = 0; i < spin_iterations_; ++i) {
+            rethrow_if_failed();
+            if (try_pop(id)) {
+                return id;
+            }
+            cpu_relax();
+        }
+        park_until([this, &id] { return try_pop(id); });
+        return id;
+    }
+
+    /// Blocks until every request has been returned to the pool.
+    void wait_all() {
+        auto all_idle = [this] { return idle_count_.load(std::memory_order_seq_cst) == capacity_; };
+        for (size_t i = 0; i < spin_iterations_; ++i) {
+            rethrow_if_failed();
+            if (all_idle()) {
+                return;
+            }
+            cpu_relax();
+        }
+        park_until(all_idle);
+    }
+
+    /// Records an inference failure; every current and future waiter rethrows it.
+    void set_exception(const std::exception_ptr& ptr) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            exception_ = ptr;
+            has_exception_.store(true, std::memory_order_release);
+        }
+        cv_.notify_all();
+    }
+
+private:
+    static constexpr uint32_t kEmpty = 0xFFFFFFFFu;
+
+    static uint64_t pack(uint32_t index, uint32_t tag) {
+        return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+
+    static uint32_t index_of(uint64_t head) {
+        return static_cast<uint32_t>(head & 0xFFFFFFFFu);
+    }
+
+    static uint32_t tag_of(uint64_t head) {
+        return static_cast<uint32_t>(head >> 32);
+    }
+
+    static void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    void rethrow_if_failed() {
+        if (has_exception_.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::rethrow_exception(exception_);
+        }
+    }
+
+    template <typename Predicate>
+    void park_until(Predicate ready) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        try {
+            cv_.wait(lock, [this, &ready] {
+                if (has_exception_.load(std::memory_order_acquire)) {
+                    std::rethrow_exception(exception_);
+                }
+                return ready();
+            });
+        } catch (...) {
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+            throw;
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void wake_waiters() {
+        if (waiters_.load(std::memory_order_seq_cst) > 0) {
+            // Taking the lock orders this wake-up after the waiter has entered cv_.wait
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_all();
+        }
+    }
+
+    std::unique_ptr<std::atomic<uint32_t>[]> next_;
+    const size_t capacity_;
+    const size_t spin_iterations_;
+
+    // Keep the hot words on separate cache lines
+    std::atomic<uint64_t> head_;
+    char pad0_[64 - sizeof(std::atomic<uint64_t>)];
+    std::atomic<size_t> idle_count_;
+    char pad1_[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<int> waiters_;
+    std::atomic<bool> has_exception_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::exception_ptr exception_ = nullptr;
+};
@@ -1,7 +1,10 @@
 #pragma once
 
-#include <queue>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstring>
 #include <mutex>
 
 #include <openvino/openvino.hpp>
@@ -15,85 +18,107 @@
 #include "system_under_test.h"
 #include "bindings/c_api.h"
 
+#include "allocation_counter.h"
+#include "idle_requests_pool.h"
 #include "item_ov.h"
+#include "post_processing_pool.h"
+#include "response_arena.h"
 
 extern std::unique_ptr<QSLBase> ds;
 
-/// Post processor function type
-typedef std::function<
-        void(Item qitem,
-            ov::InferRequest req,
-            std::vector<float> &results,
-            std::vector<mlperf::ResponseId>&response_ids,
-            unsigned batch_size,
-            std::vector<unsigned> &counts)
-    > PPFunction;
-
-typedef std::function<
-        void(size_t id,
-            ov::InferRequest req,
-            Item input,
-            std::vector<float> &results,
-            std::vector<mlperf::ResponseId> &response_ids,
-            std::vector<unsigned> &counts,
-            const std::exception_ptr& ptr)
-	> QueueCallbackFunction;
-
-typedef std::function<
-        void(size_t id,
-            ov::InferRequest req,
-            Item input,
-            std::vector<float> &results,
-            std::vector<mlperf::ResponseId> &response_ids,
-            std::vector<unsigned> &counts,
-            std::vector<mlperf::QuerySampleResponse> &respns,
-            const std::exception_ptr& ptr)
-        > ServerQueueCallbackFunction;
+/// @brief Host time spent attaching query inputs to infer requests.
+struct InputBindingStats {
+    uint64_t batches = 0;
+    uint64_t samples = 0;
+    double us = 0;
+
+    void add(std::chrono::steady_clock::time_point start, size_t num_samples) {
+        us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        ++batches;
+        samples += num_samples;
+    }
+
+    InputBindingStats& operator+=(const InputBindingStats& other) {
+        batches += other.batches;
+        samples += other.samples;
+        us += other.us;
+        return *this;
+    }
+};
+
+/// Copies an Item's inputs into request-owned tensors; inputs the QSL already wrote in place are skipped.
+template <typename Workload>
+void copy_to_bound_inputs(const Item& input, std::array<ov::Tensor, Workload::num_inputs>& bound_inputs) {
+    for (size_t i = 0; i < Workload::num_inputs; ++i) {
+        const ov::Tensor& tensor = input.tensors_[i];
+        if (tensor.data() == bound_inputs[i].data()) {
+            continue;
+        }
+        if (tensor.get_byte_size() != bound_inputs[i].get_byte_size()) {
+            throw std::runtime_error(std::string("Sample does not match bound input ") + Workload::input_names[i]);
+        }
+        std::memcpy(bound_inputs[i].data(), tensor.data(), tensor.get_byte_size());
+    }
+}
+
+/// Binds the workload's response output to harness-owned memory the plugin writes into,
+/// so responses can point at the output without a copy.
+template <typename Workload>
+void bind_response_output(ov::InferRequest& request, const ov::CompiledModel& model, std::vector<float>& buffer) {
+    auto port = model.output(Workload::response_output_name);
+    ov::Shape shape = port.get_shape();
+    buffer.resize(ov::shape_size(shape));
+    request.set_tensor(port, ov::Tensor(ov::element::f32, shape, buffer.data()));
+}
 
 /// @brief Wrapper class for ov::InferRequest. Handles asynchronous callbacks .
+///
+/// Templated on the workload traits and on the owning queue, whose put_idle_request()
+/// is called directly from the completion callback.
+template <typename Workload, typename Queue>
 class InferReqWrap final {
 public:
     using Ptr = std::shared_ptr<InferReqWrap>;
+    using PostProcessingPoolOV = PostProcessingPool<InferReqWrap>;
 
     ~InferReqWrap() = default;
 
     InferReqWrap(ov::CompiledModel& model,
                  size_t id,
-                 std::vector<std::string> input_blob_names,
-                 std::vector<std::string> output_blob_names,
                  mlperf::TestSettings settings,
-                 std::string workload,
-                 QueueCallbackFunction callback_queue) :
+                 Queue* queue,
+                 size_t max_response_size,
+                 unsigned batch_size,
+                 PostProcessingPoolOV* pp_pool = nullptr,
+                 bool prebind_inputs = false,
+                 bool zero_copy_outputs = false) :
             request_(model.create_infer_request()),
             id_(id),
-            input_blob_names_(input_blob_names),
-            output_blob_names_(output_blob_names),
             settings_(settings),
-            workload_(workload),
-            callback_queue_(callback_queue) {
-            request_.set_callback([&](const std::exception_ptr& ptr) {
-                callback_queue_(id_, request_, input_, results_, response_ids_, counts_, ptr);
-        });
+            queue_(queue),
+            pp_pool_(pp_pool),
+            prebind_inputs_(prebind_inputs) {
+        // Ports are resolved once so binding inputs needs no name lookups
+        for (size_t i = 0; i < Workload::num_inputs; ++i) {
+            input_ports_[i] = model.input(Workload::input_names[i]);
+            // The request allocates its own inputs once; queries are copied into them
+            if (prebind_inputs_) {
+                bound_inputs_[i] = request_.get_tensor(input_ports_[i]);
+            }
+        }
+        if (zero_copy_outputs) {
+            // Responses point into response_output_; the arena only holds their descriptors
+            bind_response_output<Workload>(request_, model, response_output_);
+            arena_.set_zero_copy(true);
+            max_response_size = 0;
+        }
+        arena_.reserve(max_response_size, batch_size);
+        set_completion_callback();
     }
 
-    InferReqWrap(ov::CompiledModel& model,
-                 size_t id,
-                 std::vector<std::string> input_blob_names,
-                 std::vector<std::string> output_blob_names,
-                 mlperf::TestSettings settings,
-                 std::string workload,
-                 ServerQueueCallbackFunction callback_queue,
-                 bool server) :
-            request_(model.create_infer_request()),
-            id_(id),
-            input_blob_names_(input_blob_names),
-            output_blob_names_(output_blob_names),
-            settings_(settings),
-            workload_(workload),
-            callback_queue_server_(callback_queue) {
-        request_.set_callback([&](const std::exception_ptr& ptr) {
-            callback_queue_server_(id_, request_, input_, results_, response_ids_, counts_, respns_, ptr);
-        });
+    /// Post-processes the finished request and hands it back to its queue.
+    void run_callback(const std::exception_ptr& ptr) {
+        queue_->put_idle_request(id_, request_, *input_, arena_, ptr);
     }
 
     void start_async() {
@@ -108,28 +133,38 @@ public:
         return request_.get_tensor(name);
     }
 
-    Item get_output_tensors() {
-        Item outputs;
-	    for (size_t i = 0; i < output_blob_names_.size(); ++i) {
-            outputs.tensors_.push_back( request_.get_tensor(output_blob_names_[i]));
-	    }
-	    return outputs;
+    // The Item must stay alive until the completion callback has run
+    void set_inputs(Item &input) {
+        input_ = &input;
+        auto start = std::chrono::steady_clock::now();
+        if (prebind_inputs_) {
+            copy_to_bound_inputs<Workload>(input, bound_inputs_);
+        } else {
+            for (size_t i = 0; i < Workload::num_inputs; ++i) {
+                request_.set_tensor(input_ports_[i], input_->tensors_[i]);
+            }
+        }
+        binding_stats_.add(start, input.sample_idxs_.size());
     }
 
-    void set_inputs(Item input, std::string name) {
-        input_ = input;
-        request_.set_tensor(name, input_.tensors_[0]);
+    // Points the Item's staging buffers at this request's inputs so the QSL gathers in place
+    void stage_inputs(Item &input) {
+        if (!prebind_inputs_) {
+            return;
+        }
+        input.staging_.resize(Workload::num_inputs);
+        for (size_t i = 0; i < Workload::num_inputs; ++i) {
+            input.staging_[i] = bound_inputs_[i];
+        }
+        input.staged_ = true;
     }
 
-    void set_inputs(Item input) {
-        input_ = input;
-        for (size_t i= 0; i < input_blob_names_.size(); ++i){
-            request_.set_tensor(input_blob_names_[i], input_.tensors_[i]);
-        }
+    const InputBindingStats& binding_stats() const {
+        return binding_stats_;
     }
 
     unsigned get_batch_size(){
-        return input_.sample_idxs_.size();
+        return input_->sample_idxs_.size();
     }
 
     void set_is_warmup(bool warmup) {
@@ -141,228 +176,220 @@ public:
     }
 
     void reset() {
-        response_ids_.clear();
-        counts_.clear();
-        results_.clear();
-        respns_.clear();
+        arena_.clear();
     }
 
 public:
-    std::vector<mlperf::ResponseId> response_ids_;
-    std::vector<unsigned> counts_;
-    std::vector<float> results_;
-    std::vector<mlperf::QuerySampleResponse> respns_;
+    ResponseArena arena_;
 
 private:
+    // With a post-processing pool the OpenVINO callback thread only enqueues the request
+    void set_completion_callback() {
+        request_.set_callback([this](const std::exception_ptr& ptr) {
+            if (pp_pool_) {
+                pp_pool_->submit(this, ptr);
+            } else {
+                run_callback(ptr);
+            }
+        });
+    }
+
     ov::InferRequest request_;
     size_t id_;
-    std::vector<std::string> input_blob_names_, output_blob_names_;
+    std::array<ov::Output<const ov::Node>, Workload::num_inputs> input_ports_;
     mlperf::TestSettings settings_;
-    std::string workload_;
-    QueueCallbackFunction callback_queue_;
-    ServerQueueCallbackFunction callback_queue_server_;
-
-    Item input_;
-    Item outputs_;
+    Queue* queue_;
+    PostProcessingPoolOV* pp_pool_;
+    bool prebind_inputs_;
+    std::array<ov::Tensor, Workload::num_inputs> bound_inputs_;
+    std::vector<float> response_output_;
+    InputBindingStats binding_stats_;
+
+    Item *input_ = nullptr;
     bool is_warmup = false;
 };
 
+template <typename Workload>
 class InferRequestsQueue final {
 public:
+    using Request = InferReqWrap<Workload, InferRequestsQueue>;
+
     InferRequestsQueue(ov::CompiledModel& model,
                        size_t nireq,
-                       std::vector<std::string> input_blob_names,
-                       std::vector<std::string> output_blob_names,
                        mlperf::TestSettings settings,
-                       std::string workload,
                        unsigned batch_size,
-                       PPFunction post_processor) :
+                       size_t max_response_size,
+                       unsigned pp_threads = 0,
+                       const std::string& pp_cores = "",
+                       bool prebind_inputs = false,
+                       bool zero_copy_outputs = false) :
             num_batches_(),
             settings_(settings),
-            workload_(workload),
             batch_size_(batch_size),
-            post_processor_(post_processor) {
+            is_warmup_(false),
+            idle_requests_(nireq),
+            pp_pool_(Request::PostProcessingPoolOV::create(pp_threads, pp_cores)) {
+        output_ports_ = mlperf_ov::resolve_output_ports<Workload>(model, zero_copy_outputs);
         for (size_t id = 0; id < nireq; id++) {
             requests.push_back(
-                    std::make_shared<InferReqWrap>(model, id, input_blob_names, output_blob_names, settings, workload,
-                            std::bind(
-                                    &InferRequestsQueue::put_idle_request, this,
-                                    std::placeholders::_1,
-                                    std::placeholders::_2,
-				                    std::placeholders::_3,
-				                    std::placeholders::_4,
-				                    std::placeholders::_5,
-				                    std::placeholders::_6,
-                                    std::placeholders::_7)));
-            idle_ids_.push(id);
+                    std::make_shared<Request>(model, id, settings, this,
+                            max_response_size, batch_size, pp_pool_.get(), prebind_inputs, zero_copy_outputs));
+            idle_requests_.push(id);
         }
     }
 
     ~InferRequestsQueue() = default;
 
     void put_idle_request(size_t id,
-                          ov::InferRequest req,
-                           Item qitem,
-                          std::vector<float> &results,
-                          std::vector<mlperf::ResponseId> &response_ids,
-                          std::vector<unsigned> &counts,
+                          ov::InferRequest &req,
+                          Item &qitem,
+                          ResponseArena &arena,
                           const std::exception_ptr& ptr) {
-        post_processor_(qitem, req, results, response_ids, batch_size_, counts);
-        std::unique_lock<std::mutex> lock(mutex_);
+        ALLOCATION_SCOPE();
+        Workload::postprocess(qitem, req, output_ports_, arena, batch_size_);
+        // Pooled Items go back to their producer; SUT-owned Items are left alone
+        qitem.release();
+
+        // Report this request's samples right away instead of once per query
+        if (!(is_warmup_) && arena.num_responses() > 0) {
+            ALLOCATION_SCOPE_PAUSE();
+            mlperf::QuerySamplesComplete(arena.responses(), arena.num_responses());
+        }
+        arena.clear();
+
         if (ptr) {
             inference_exception_ = ptr;
+            idle_requests_.set_exception(ptr);
         } else {
-            idle_ids_.push(id);
+            idle_requests_.push(id);
         }
-        cv_.notify_one();
-    }
-
-    InferReqWrap::Ptr get_idle_request() {
-        std::unique_lock<std::mutex> lock(mutex_);
-        cv_.wait(lock, [this] {
-            if (inference_exception_) {
-                std::rethrow_exception(inference_exception_);
-            }
-            return idle_ids_.size() > 0;
-        });
-        auto request = requests.at(idle_ids_.front());
-        idle_ids_.pop();
-        return request;
     }
 
-    void wait_all() {
-        std::unique_lock<std::mutex> lock(mutex_);
-        cv_.wait(lock, [this] {
-            if (inference_exception_) {
-                std::rethrow_exception(inference_exception_);
-            }
-            return idle_ids_.size() == requests.size();
-        });
-
-	    size_t j = 0;
-	    for (auto &req : requests ){
-            size_t idx = 0;
-            for (size_t i = 0; i < req->counts_.size(); ++i) {
-                mlperf::QuerySampleResponse response { req->response_ids_[i],
-                    reinterpret_cast<std::uintptr_t>(&(req->results_[idx])),
-                    (sizeof(float) * req->counts_[i]) };
-                responses_.push_back(response);
-                idx = idx + req->counts_[i];
-            }
-	    }
+    void set_warmup(bool warmup) {
+        is_warmup_ = warmup;
     }
 
-    std::vector<Item> get_outputs() {
-        return outputs_;
+    typename Request::Ptr get_idle_request() {
+        return requests.at(idle_requests_.pop());
     }
 
-    std::vector<mlperf::QuerySampleResponse> get_query_sample_responses(){
-        return responses_;
+    void wait_all() {
+        idle_requests_.wait_all();
     }
 
     void reset() {
-        outputs_.clear();
-        responses_.clear();
         for (auto &req : requests){
             req->reset();
         }
     }
 
-    std::vector<InferReqWrap::Ptr> requests;
+    std::vector<typename Request::Ptr> requests;
 
 private:
-    std::queue<size_t> idle_ids_;
-    std::mutex mutex_;
-    std::condition_variable cv_;
-
     mlperf::TestSettings settings_;
-    std::string out_name_;
-    std::string workload_;
-    std::vector<Item> outputs_;
-    std::vector<mlperf::QuerySampleResponse> responses_;
     unsigned batch_size_, num_batches_;
-    PPFunction post_processor_;
+    std::atomic<bool> is_warmup_;
+    IdleRequestsPool idle_requests_;
     std::exception_ptr inference_exception_ = nullptr;
+    mlperf_ov::OutputPorts<Workload::num_outputs> output_ports_;
+    // Declared last so workers are joined before the requests they reference go away
+    std::unique_ptr<typename Request::PostProcessingPoolOV> pp_pool_;
 };
 
 
 
 /**================================== Server Queue Runner ================================**/
 
+template <typename Workload>
 class InferRequestsQueueServer {
 public:
+    using Request = InferReqWrap<Workload, InferRequestsQueueServer>;
+
     InferRequestsQueueServer(ov::CompiledModel& model,
                              size_t nireq,
-                             std::vector<std::string> input_blob_names,
-                             std::vector<std::string> output_blob_names,
                              mlperf::TestSettings settings,
-                             std::string workload,
                              unsigned batch_size,
-                             PPFunction post_processor) :
+                             size_t max_response_size,
+                             unsigned pp_threads = 0,
+                             const std::string& pp_cores = "",
+                             bool prebind_inputs = false,
+                             bool zero_copy_outputs = false) :
             num_batches_(),
             settings_(settings),
-            workload_(workload),
             batch_size_(batch_size),
-            post_processor_(post_processor),
-            is_warmup_(false) {
+            is_warmup_(false),
+            idle_requests_(nireq),
+            in_service_(nireq),
+            target_(nireq),
+            pp_pool_(Request::PostProcessingPoolOV::create(pp_threads, pp_cores)) {
+        output_ports_ = mlperf_ov::resolve_output_ports<Workload>(model, zero_copy_outputs);
 	    for (size_t id = 0; id < nireq; id++) {
             requests.push_back(
-                    std::make_shared<InferReqWrap>(model, id, input_blob_names, output_blob_names, settings, workload,
-                                std::bind(
-                                    &InferRequestsQueueServer::put_idle_request, this,
-                                    std::placeholders::_1,
-                                    std::placeholders::_2,
-                                    std::placeholders::_3,
-                                    std::placeholders::_4,
-                                    std::placeholders::_5,
-                                    std::placeholders::_6,
-				                    std::placeholders::_7,
-                                    std::placeholders::_8),
-                                    true));
-            idle_ids_.push(id);
+                    std::make_shared<Request>(model, id, settings, this,
+                            max_response_size, batch_size, pp_pool_.get(), prebind_inputs, zero_copy_outputs));
+            idle_requests_.push(id);
         }
+        parked_.reserve(nireq);
     }
 
     ~InferRequestsQueueServer() = default;
 
     void put_idle_request(size_t id,
-                          ov::InferRequest req,
-                          Item qitem,
-                          std::vector<float> &results,
-                          std::vector<mlperf::ResponseId> &response_ids,
-                          std::vector<unsigned> &counts,
-                          std::vector<mlperf::QuerySampleResponse> &respns,
+                          ov::InferRequest &req,
+                          Item &qitem,
+                          ResponseArena &arena,
                           const std::exception_ptr& ptr = nullptr){
-        post_processor_(qitem, req, results, response_ids, batch_size_, counts);
-
-        size_t idx = 0;
-
-        for (size_t i = 0; i < counts.size(); ++i) {
-            mlperf::QuerySampleResponse response { response_ids[i],
-                reinterpret_cast<std::uintptr_t>(&(results[idx])),
-                (sizeof(float) * counts[i]) };
-            respns.push_back(response);
-            idx = idx + counts[i];
-        }
+        ALLOCATION_SCOPE();
+        Workload::postprocess(qitem, req, output_ports_, arena, batch_size_);
+        qitem.release();
 
         if (!(is_warmup_)){
-            mlperf::QuerySamplesComplete( respns.data(), respns.size() );
+            ALLOCATION_SCOPE_PAUSE();
+            mlperf::QuerySamplesComplete(arena.responses(), arena.num_responses());
         }
+        arena.clear();
 
-        results.clear();
-        counts.clear();
-        response_ids.clear();
-        respns.clear();
-
-        std::unique_lock < std::mutex > lock(mutex_);
         if (ptr) {
             inference_exception_ = ptr;
-        } else {
-            idle_ids_.push(id);
+            idle_requests_.set_exception(ptr);
+        } else if (in_service_.load(std::memory_order_relaxed) <= target_.load(std::memory_order_relaxed) ||
+                   !park(id)) {
+            idle_requests_.push(id);
         }
-        cv_.notify_one();
     }
 
+    // Elastic pool: requests above the target are parked as they complete instead of going
+    // back to the idle pool; raising the target returns parked requests right away.
+    void set_target_requests(size_t target) {
+        std::lock_guard<std::mutex> lock(elastic_mutex_);
+        target_.store(std::min(std::max<size_t>(target, 1), requests.size()), std::memory_order_relaxed);
+        while (in_service_.load(std::memory_order_relaxed) < target_.load(std::memory_order_relaxed) &&
+               !parked_.empty()) {
+            size_t id = parked_.back();
+            parked_.pop_back();
+            in_service_.fetch_add(1, std::memory_order_relaxed);
+            idle_requests_.push(id);
+        }
+    }
+
+    size_t target_requests() const {
+        return target_.load(std::memory_order_relaxed);
+    }
+
+    size_t requests_in_service() const {
+        return in_service_.load(std::memory_order_relaxed);
+    }
+
+    size_t busy_requests() const {
+        size_t in_service = requests_in_service();
+        return in_service - std::min(in_service, idle_requests_.idle_count());
+    }
+
+    // Request acquisitions, those that found every request in service busy, and their total wait
+    uint64_t acquires() const { return acquires_.load(std::memory_order_relaxed); }
+    uint64_t blocked_acquires() const { return blocked_acquires_.load(std::memory_order_relaxed); }
+    uint64_t blocked_wait_ns() const { return blocked_wait_ns_.load(std::memory_order_relaxed); }
+
 
     void set_warmup(bool warmup){
 	    is_warmup_ = warmup;
@@ -370,36 +397,26 @@ public:
 
     // Maybe different post-completion tasks for warmup
     void warmup_put_idle_req(size_t id){
-        std::unique_lock<std::mutex> lock(mutex_);
-        idle_ids_.push(id);
-        cv_.notify_one();
+        idle_requests_.push(id);
     }
 
-    InferReqWrap::Ptr get_idle_request() {
-        std::unique_lock<std::mutex> lock(mutex_);
-        cv_.wait(lock, [this] {
-            if (inference_exception_) {
-                std::rethrow_exception(inference_exception_);
-            }
-            return idle_ids_.size() > 0;
-        });
-        auto request = requests.at(idle_ids_.front());
-        idle_ids_.pop();
-        return request;
+    typename Request::Ptr get_idle_request() {
+        acquires_.fetch_add(1, std::memory_order_relaxed);
+        size_t id = 0;
+        if (!idle_requests_.try_pop(id)) {
+            auto start = std::chrono::steady_clock::now();
+            id = idle_requests_.pop();
+            blocked_acquires_.fetch_add(1, std::memory_order_relaxed);
+            blocked_wait_ns_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+        }
+        return requests.at(id);
     }
 
+    // Parked requests are brought back first so the pool can drain completely
     void wait_all() {
-        std::unique_lock<std::mutex> lock(mutex_);
-        cv_.wait(lock, [this] {
-            if (inference_exception_) {
-                std::rethrow_exception(inference_exception_);
-            }
-            return idle_ids_.size() == requests.size();
-        });
-    }
-
-    std::vector<Item> getOutputs() {
-        return outputs_;
+        set_target_requests(requests.size());
+        idle_requests_.wait_all();
     }
 
     std::vector<mlperf::QuerySampleResponse> get_query_sample_responses(){
@@ -407,28 +424,41 @@ public:
     }
 
     void reset() {
-        outputs_.clear();
         responses_.clear();
         for (auto &req : requests){
             req->reset();
         }
     }
 
-    std::vector<InferReqWrap::Ptr> requests;
+    std::vector<typename Request::Ptr> requests;
 
 private:
-    std::queue<size_t> idle_ids_;
-    std::mutex mutex_;
-    std::condition_variable cv_;
+    // Called on completion while more requests are in service than the target
+    bool park(size_t id) {
+        std::lock_guard<std::mutex> lock(elastic_mutex_);
+        if (in_service_.load(std::memory_order_relaxed) <= target_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        parked_.push_back(id);
+        in_service_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
 
     mlperf::TestSettings settings_;
-    std::string out_name_;
-    std::string workload_;
-    std::vector<Item> outputs_;
     std::vector<mlperf::QuerySampleResponse> responses_;
     unsigned batch_size_, num_batches_;
-    PPFunction post_processor_;
     bool is_warmup_;
+    IdleRequestsPool idle_requests_;
     std::exception_ptr inference_exception_ = nullptr;
+    mlperf_ov::OutputPorts<Workload::num_outputs> output_ports_;
+    // Elastic pool state; the mutex is only taken to park or unpark a request
+    std::atomic<size_t> in_service_;
+    std::atomic<size_t> target_;
+    std::vector<size_t> parked_;
+    std::mutex elastic_mutex_;
+    std::atomic<uint64_t> acquires_{0};
+    std::atomic<uint64_t> blocked_acquires_{0};
+    std::atomic<uint64_t> blocked_wait_ns_{0};
+    std::unique_ptr<typename Request::PostProcessingPoolOV> pp_pool_;
 };
 
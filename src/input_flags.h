@@ -23,10 +23,10 @@ DEFINE_validator(scenario, &validate_scenario);
 
 
 // Mode flag
-static const char mode_message[] = "MLPerf mode: Performance, Accuracy";
+static const char mode_message[] = "MLPerf mode: Performance, Accuracy, AutoTune, PrecisionAB";
 
 static bool validate_mode(const char* mode, const std::string& value){
-    std::list<std::string> modes = {"Performance", "Accuracy"};
+    std::list<std::string> modes = {"Performance", "Accuracy", "AutoTune", "PrecisionAB"};
 
     for (std::list<std::string>::iterator it = modes.begin(); it != modes.end(); ++it){
         if (value.compare(*it) == 0) return true;
@@ -217,8 +217,34 @@ static bool validate_extensions(const char* extensions, const std::string& exten
 DEFINE_string(extensions, "", custom_extensions_library_message);
 DEFINE_validator(extensions, &validate_extensions);
 
-static const char infer_requests_count_message[] = "Optional. Number of infer requests. Default value is determined automatically for device.";
-DEFINE_uint32(nireq, 1, infer_requests_count_message);
+static const char infer_requests_count_message[] = "Optional. Number of infer requests. 0 (default) uses the device's optimal number.";
+DEFINE_uint32(nireq, 0, infer_requests_count_message);
+
+static const char nireq_max_message[] = "Optional. Server: upper bound of an elastic infer request pool that starts at --nireq and grows "
+                                        "while dispatchers wait for idle requests and shrinks while requests sit idle. 0 (default) keeps --nireq fixed.";
+DEFINE_uint32(nireq_max, 0, nireq_max_message);
+
+static const char nireq_min_message[] = "Optional. Server with --nireq_max: lower bound of the elastic infer request pool. Defaults to 1.";
+DEFINE_uint32(nireq_min, 1, nireq_min_message);
+
+static const char elastic_interval_ms_message[] = "Optional. Server with --nireq_max: milliseconds between two resizes of the infer request pool. Defaults to 100.";
+DEFINE_uint32(elastic_interval_ms, 100, elastic_interval_ms_message);
+
+static const char numa_instances_message[] = "Optional. Offline: number of backend instances, one per NUMA node, each with its own compiled model "
+                                             "and infer requests on that node's cores and a node-local shard of the samples. "
+                                             "--nstreams, --nthreads and --nireq apply to every instance. 0 or 1 (default) runs one instance.";
+DEFINE_uint32(numa_instances, 0, numa_instances_message);
+
+static const char load_threads_message[] = "Optional. ResNet50 and RetinaNet: threads decoding and preprocessing images when samples are loaded "
+                                           "to RAM, split across --numa_instances nodes. 0 (default) uses every hardware thread.";
+DEFINE_uint32(load_threads, 0, load_threads_message);
+
+static const char sample_cache_dir_message[] = "Optional. ResNet50 and RetinaNet: directory of preprocessed sample files. Each image is "
+                                               "preprocessed once, when a run first loads it, into a file keyed by dataset, workload, image size and "
+                                               "preprocessing version; later runs memory-map it instead of decoding images. SingleStream and Server "
+                                               "use the mapped samples in place, Offline and MultiStream copy them into a contiguous slab. "
+                                               "Empty (default) disables it.";
+DEFINE_string(sample_cache_dir, "", sample_cache_dir_message);
 
 static const char infer_num_threads_message[] = "Optional. Number of threads to use for inference on the CPU "
                                                 "(including HETERO and MULTI cases).";
@@ -231,9 +257,112 @@ DEFINE_string(nstreams, "", infer_num_streams_message);
 static const char batch_size_message[] = "Optional. Batch size value. If not specified, the batch size value is determined from Intermediate Representation.";
 DEFINE_uint32(batch_size, 1, batch_size_message);
 
-static const char warmup_message[] = "Number of warmup iterations. Defaults to 10.";
+static const char dynamic_batch_message[] = "Optional. Offline and MultiStream: compile the batch dimension as [1, batch_size] so a query's "
+                                            "partial last batch runs unpadded. Without it the partial batch is padded to the full batch size.";
+DEFINE_bool(dynamic_batch, false, dynamic_batch_message);
+
+static const char warmup_message[] = "Minimum number of warmup rounds; a round runs every infer request once. 0 disables warmup. Defaults to 10.";
 DEFINE_uint32(warmup_iters, 10, warmup_message);
 
+static const char warmup_max_iters_message[] = "Optional. Warmup stops after this many rounds even if round latency has not converged. Defaults to 100.";
+DEFINE_uint32(warmup_max_iters, 100, warmup_max_iters_message);
+
+static const char warmup_window_message[] = "Optional. Number of most recent warmup rounds whose latency must converge. Defaults to 5.";
+DEFINE_uint32(warmup_window, 5, warmup_window_message);
+
+static const char warmup_cv_message[] = "Optional. Warmup has converged once the coefficient of variation of the round latencies "
+                                        "in the window is at most this value. Defaults to 0.05.";
+DEFINE_double(warmup_cv, 0.05, warmup_cv_message);
+
+static const char dispatch_threads_message[] = "Optional. Number of Server scenario threads dispatching queued queries to idle infer requests. Defaults to 1.";
+DEFINE_uint32(dispatch_threads, 1, dispatch_threads_message);
+
+static const char batching_latency_fraction_message[] = "Optional. Server scenario with --batch_size > 1: share of the target latency "
+                                                        "a query may wait for its batch to fill up. Defaults to 0.1.";
+DEFINE_double(batching_latency_fraction, 0.1, batching_latency_fraction_message);
+
+static const char pp_threads_message[] = "Optional. Number of dedicated post-processing threads for Offline, MultiStream and Server. "
+                                         "0 (default) runs post-processing in the OpenVINO completion callback.";
+DEFINE_uint32(pp_threads, 0, pp_threads_message);
+
+static const char pp_cores_message[] = "Optional. Cores to pin post-processing threads to, e.g. '0-3,8'. Defaults to no pinning.";
+DEFINE_string(pp_cores, "", pp_cores_message);
+
+static const char ss_cores_message[] = "Optional. SingleStream: cores to pin the issuing thread to, e.g. '0'. Defaults to no pinning.";
+DEFINE_string(ss_cores, "", ss_cores_message);
+
+static const char ss_busy_poll_message[] = "Optional. SingleStream: busy-poll the infer request for completion instead of blocking. "
+                                           "Trades a fully used core for lower latency.";
+DEFINE_bool(ss_busy_poll, false, ss_busy_poll_message);
+
+static const char model_cache_dir_message[] = "Optional. Directory for cached compiled models. A cached model is imported instead of "
+                                              "being compiled when the model files and compile options match. Defaults to no cache.";
+DEFINE_string(model_cache_dir, "", model_cache_dir_message);
+
+static const char mmap_weights_message[] = "Optional. Read IR weights through a read-only memory map so backend instances and "
+                                           "processes on one host share the .bin pages. Defaults to true.";
+DEFINE_bool(mmap_weights, true, mmap_weights_message);
+
+static const char autotune_nstreams_message[] = "Optional. AutoTune: comma-separated nstreams values to try. "
+                                                "Defaults to 1 for SingleStream and 1,2,4,cores/4,cores/2 otherwise.";
+DEFINE_string(autotune_nstreams, "", autotune_nstreams_message);
+
+static const char autotune_nthreads_message[] = "Optional. AutoTune: comma-separated nthreads values to try. Defaults to 0 (device default).";
+DEFINE_string(autotune_nthreads, "0", autotune_nthreads_message);
+
+static const char autotune_nireq_message[] = "Optional. AutoTune: comma-separated nireq values to try. Defaults to 0 (device optimal).";
+DEFINE_string(autotune_nireq, "0", autotune_nireq_message);
+
+static const char autotune_batch_size_message[] = "Optional. AutoTune: comma-separated batch sizes to try. "
+                                                  "Defaults to 1 for SingleStream and 1,2,4,8 otherwise.";
+DEFINE_string(autotune_batch_size, "", autotune_batch_size_message);
+
+static const char autotune_duration_message[] = "Optional. AutoTune: duration of each trial run in milliseconds. Defaults to 10000.";
+DEFINE_uint32(autotune_duration_ms, 10000, autotune_duration_message);
+
+static const char autotune_qps_steps_message[] = "Optional. AutoTune, Server: number of 10% target QPS increases tried per "
+                                                 "configuration while latency constraints hold. Defaults to 4.";
+DEFINE_uint32(autotune_qps_steps, 4, autotune_qps_steps_message);
+
+static const char graph_preprocess_message[] = "Optional. ResNet50/RetinaNet: keep cropped and resized images in RAM as NHWC BGR u8 "
+                                              "and run type conversion, color conversion and layout change inside the compiled graph "
+                                              "instead of on the host.";
+DEFINE_bool(graph_preprocess, false, graph_preprocess_message);
+
+static const char graph_preprocess_size_message[] = "Optional. --graph_preprocess: side of the stored square images. Defaults to "
+                                                   "the model size (224 for resnet50, 800 for retinanet); other sizes add a linear resize in the graph.";
+DEFINE_uint32(graph_preprocess_size, 0, graph_preprocess_size_message);
+
+static const char ingraph_topk_message[] = "Optional. ResNet50: append TopK(1) to the classifier so each sample returns "
+                                          "its class index instead of 1001 scores.";
+DEFINE_bool(ingraph_topk, false, ingraph_topk_message);
+
+static const char prebind_inputs_message[] = "Optional. Copy each query into input tensors the infer requests allocate once "
+                                            "instead of calling set_tensor() per query. The QSL gathers each batch straight into "
+                                            "the request it runs on. The per-query binding time is reported for comparison.";
+DEFINE_bool(prebind_inputs, false, prebind_inputs_message);
+
+static const char zero_copy_outputs_message[] = "Optional. BERT: interleave the start and end logits in the graph into one output "
+                                               "bound to harness memory, so responses point at the inference output with no copy. "
+                                               "Ignored with --seq_buckets and --dynamic_batch.";
+DEFINE_bool(zero_copy_outputs, false, zero_copy_outputs_message);
+
+static const char seq_buckets_message[] = "Optional. BERT: comma-separated sequence-length buckets, e.g. '128,192,256,384'. "
+                                         "Compiles a dynamic sequence dimension and batches Offline, Server and MultiStream "
+                                         "samples by bucket. Defaults to every sample padded to 384 tokens.";
+DEFINE_string(seq_buckets, "", seq_buckets_message);
+
+static const char ab_precisions_message[] = "Optional. PrecisionAB: comma-separated inference precisions to compare; "
+                                           "the first is the accuracy reference. Defaults to f32,bf16.";
+DEFINE_string(ab_precisions, "f32,bf16", ab_precisions_message);
+
+static const char ab_accuracy_samples_message[] = "Optional. PrecisionAB: number of samples scored per precision. Defaults to 500.";
+DEFINE_uint32(ab_accuracy_samples, 500, ab_accuracy_samples_message);
+
+static const char ab_duration_message[] = "Optional. PrecisionAB: duration of each precision's performance run in milliseconds. "
+                                          "Defaults to 10000.";
+DEFINE_uint32(ab_duration_ms, 10000, ab_duration_message);
+
 static const char inference_precision_message[] =
     "Optional. Specifies the inference precision. Example #1: '-infer_precision bf16'. Example #2: '-infer_precision "
     "CPU:bf16,GPU:f32'";
@@ -8,6 +8,7 @@
 #include <openvino/openvino.hpp>
 
 #include "bindings/c_api.h"
+#include "idle_requests_pool.h"
 #include "loadgen.h"
 #include "query_sample.h"
 #include "query_sample_library.h"
@@ -16,41 +17,125 @@
 
 using namespace InferenceEngine;
 
+class ItemPool;
+
+/// @brief Inputs and loadgen ids of one inference request.
+///
+/// Items are move-only and are passed by reference from the QSL through the
+/// backend to the post-processors. QSLs refill an existing Item in place, so a
+/// reused Item performs no heap allocation once its vectors have grown to the
+/// batch size.
 class Item {
 public:
     Item(ov::Tensor tensor, std::vector<mlperf::ResponseId> response_ids,
         std::vector<mlperf::QuerySampleIndex> sample_idxs)
         : tensors_({tensor}),
-        response_ids_(response_ids),
-        sample_idxs_(sample_idxs),
+        response_ids_(std::move(response_ids)),
+        sample_idxs_(std::move(sample_idxs)),
         label_() {}
 
     Item(ov::Tensor tensor, std::vector<mlperf::ResponseId> response_ids,
         std::vector<mlperf::QuerySampleIndex> sample_idxs, int label)
         : tensors_({tensor}),
-        response_ids_(response_ids),
-        sample_idxs_(sample_idxs),
+        response_ids_(std::move(response_ids)),
+        sample_idxs_(std::move(sample_idxs)),
         label_(label) {}
 
     Item(ov::Tensor tensor, std::vector<mlperf::QuerySampleIndex> sample_idxs)
         : tensors_({tensor}),
-        sample_idxs_(sample_idxs) {}
+        sample_idxs_(std::move(sample_idxs)) {}
 
     Item(std::vector<ov::Tensor> tensors,
         std::vector<mlperf::ResponseId> response_ids,
         std::vector<mlperf::QuerySampleIndex> sample_idxs)
-        : tensors_(tensors),
-        response_ids_(response_ids),
-        sample_idxs_(sample_idxs),
+        : tensors_(std::move(tensors)),
+        response_ids_(std::move(response_ids)),
+        sample_idxs_(std::move(sample_idxs)),
         label_() {}
 
     Item() : label_() {}
 
+    Item(const Item&) = delete;
+    Item& operator=(const Item&) = delete;
+    Item(Item&&) = default;
+    Item& operator=(Item&&) = default;
+
+    void reserve(size_t num_inputs, size_t batch_size) {
+        tensors_.reserve(num_inputs);
+        staging_.reserve(num_inputs);
+        response_ids_.reserve(batch_size);
+        sample_idxs_.reserve(batch_size);
+    }
+
+    /// Copies samples [begin, begin + count) and their ids without reallocating.
+    void set_samples(const std::vector<mlperf::QuerySampleIndex>& samples,
+                     const std::vector<mlperf::ResponseId>& response_ids,
+                     size_t begin, size_t count) {
+        sample_idxs_.assign(samples.begin() + begin, samples.begin() + begin + count);
+        response_ids_.assign(response_ids.begin() + begin, response_ids.begin() + begin + count);
+    }
+
+    /// Returns a pooled Item to its pool; no-op for Items owned elsewhere.
+    void release();
+
 public:
     std::vector<mlperf::ResponseId> response_ids_;
     std::vector<mlperf::QuerySampleIndex> sample_idxs_;
     std::vector<ov::Tensor> tensors_;
+    // Batch buffers owned by this Item and reused when a QSL has to copy samples
+    std::vector<ov::Tensor> staging_;
+    // Set once staging_ holds the input tensors of the request the Item runs on; QSLs then
+    // gather every batch into them instead of handing out views of their sample memory
+    bool staged_ = false;
     int label_;
+
+private:
+    friend class ItemPool;
+    ItemPool* pool_ = nullptr;
+    size_t slot_ = 0;
+};
+
+/// @brief Fixed set of preallocated Items shared by a producer and the completion path.
+class ItemPool final {
+public:
+    ItemPool(size_t capacity, size_t num_inputs, size_t batch_size) :
+            items_(capacity),
+            free_items_(capacity) {
+        for (size_t i = 0; i < capacity; ++i) {
+            items_[i].reserve(num_inputs, batch_size);
+            items_[i].pool_ = this;
+            items_[i].slot_ = i;
+            free_items_.push(i);
+        }
+    }
+
+    ItemPool(const ItemPool&) = delete;
+    ItemPool& operator=(const ItemPool&) = delete;
+
+    /// Blocks until an Item is free.
+    Item& acquire() {
+        return items_[free_items_.pop()];
+    }
+
+    void release(Item& item) {
+        free_items_.push(item.slot_);
+    }
+
+private:
+    std::vector<Item> items_;
+    IdleRequestsPool free_items_;
 };
 
+inline void Item::release() {
+    if (pool_) {
+        // The next holder may run on another request, so drop views of this one's inputs;
+        // staging buffers the Item allocated itself are kept for reuse
+        if (staged_) {
+            staging_.clear();
+            staged_ = false;
+        }
+        pool_->release(*this);
+    }
+}
+
 #endif
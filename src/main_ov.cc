@@ -17,6 +17,11 @@
 #include "suts/sut_multistream.h"
 #include "suts/sut_offline.h"
 #include "suts/sut_server.h"
+#include "suts/sut_singlestream.h"
+
+#include "autotune.h"
+#include "numa.h"
+#include "precision_ab.h"
 
 #include "input_flags.h"
 #include "workload_helpers.h"
@@ -26,15 +31,38 @@
 #define MILLI_SEC 1000
 #define MILLI_TO_NANO 1000000
 
+// Instantiates the SUT stack for one workload; the scenario is chosen at runtime
+template <typename Workload>
+std::unique_ptr<SUTInterface> CreateSUT(const mlperf::TestSettings& settings, QSLBase* qsl,
+                                        const OVBackendProperties& ov_properties, unsigned batch_size,
+                                        const ServerProperties& server_properties,
+                                        const SingleStreamProperties& ss_properties) {
+    if (settings.scenario == mlperf::TestScenario::SingleStream) {
+        return std::unique_ptr<SUTInterface>(new SUTSingleStream<Workload>(settings, qsl, ov_properties,
+                    batch_size, FLAGS_dataset, FLAGS_model_name, FLAGS_model_path, ss_properties));
+    } else if (settings.scenario == mlperf::TestScenario::Offline) {
+        return std::unique_ptr<SUTInterface>(new SUTOffline<Workload>(settings, qsl, ov_properties, batch_size,
+                    FLAGS_dataset, FLAGS_model_name, FLAGS_model_path));
+    } else if (settings.scenario == mlperf::TestScenario::MultiStream) {
+        return std::unique_ptr<SUTInterface>(new SUTMultistream<Workload>(settings, qsl, ov_properties, batch_size,
+                    FLAGS_dataset, FLAGS_model_name, FLAGS_model_path));
+    } else if (settings.scenario == mlperf::TestScenario::Server) {
+        return std::unique_ptr<SUTInterface>(new SUTServer<Workload>(settings, qsl, ov_properties, batch_size,
+                    FLAGS_dataset, FLAGS_model_name, FLAGS_model_path, server_properties));
+    }
+    return nullptr;
+}
+
 int main(int argc, char **argv) {
     std::unique_ptr<QSLBase> ov_qsl;
-    std::unique_ptr<SUTBase> ov_sut;
+    std::unique_ptr<SUTInterface> ov_sut;
     mlperf::TestSettings settings;
     mlperf::LogSettings log_settings;
 
-    PPFunction post_processor;
-
-    std::unique_ptr<mlperf_ov::WorkloadBase> workload;
+    decltype(&CreateSUT<mlperf_ov::ResNet50>) create_sut = nullptr;
+    decltype(&RunPrecisionAB<mlperf_ov::ResNet50>) run_precision_ab = nullptr;
+    mlperf_ov::WorkloadName workload_name;
+    mlperf_ov::DatasetName dataset_name;
 
     // Parse Command flags
     gflags::ParseCommandLineFlags(&argc, &argv, true);
@@ -59,7 +87,8 @@ int main(int argc, char **argv) {
         { "Performance",         mlperf::TestMode::PerformanceOnly},
         { "Submission",          mlperf::TestMode::SubmissionRun},
         { "FindPeakPerformance", mlperf::TestMode::FindPeakPerformance},
-        { "FindPeakPerformance", mlperf::TestMode::FindPeakPerformance},
+        { "AutoTune",            mlperf::TestMode::PerformanceOnly},
+        { "PrecisionAB",         mlperf::TestMode::PerformanceOnly},
     };
     if (!FLAGS_mode.empty() && mode_map.count(FLAGS_mode)) {
         settings.mode = mode_map.at(FLAGS_mode);
@@ -91,21 +120,27 @@ int main(int argc, char **argv) {
     }
 
     if (FLAGS_model_name.compare("resnet50") == 0) {
-	    post_processor = std::bind(&Processors::postprocess_resnet50, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5, std::placeholders::_6);
-        workload = std::unique_ptr<mlperf_ov::ResNet50>(new mlperf_ov::ResNet50());
+        create_sut = &CreateSUT<mlperf_ov::ResNet50>;
+        run_precision_ab = &RunPrecisionAB<mlperf_ov::ResNet50>;
+        workload_name = mlperf_ov::ResNet50::workload_name;
+        dataset_name = mlperf_ov::ResNet50::dataset_name;
         image_format = "NCHW";
         image_height = 224;
         image_width = 224;
         num_channels = 3;
     } else if (FLAGS_model_name.compare("bert") == 0) {
-        post_processor = std::bind(&Processors::postprocess_bert, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5, std::placeholders::_6);
-	    workload = std::unique_ptr<mlperf_ov::Bert>(new mlperf_ov::Bert());
+        create_sut = &CreateSUT<mlperf_ov::Bert>;
+        run_precision_ab = &RunPrecisionAB<mlperf_ov::Bert>;
+        workload_name = mlperf_ov::Bert::workload_name;
+        dataset_name = mlperf_ov::Bert::dataset_name;
         max_seq_length = 384;
         max_query_length = 64;
         doc_stride = 128;
     } else if (FLAGS_model_name.compare("retinanet") == 0) {
-        post_processor = std::bind(&Processors::postprocess_ssd_retinanet, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5, std::placeholders::_6);
-	    workload = std::unique_ptr<mlperf_ov::RetinaNet>(new mlperf_ov::RetinaNet());
+        create_sut = &CreateSUT<mlperf_ov::RetinaNet>;
+        run_precision_ab = &RunPrecisionAB<mlperf_ov::RetinaNet>;
+        workload_name = mlperf_ov::RetinaNet::workload_name;
+        dataset_name = mlperf_ov::RetinaNet::dataset_name;
         image_format = "NCHW";
         image_height = 800;
         image_width = 800;
@@ -114,13 +149,6 @@ int main(int argc, char **argv) {
         throw std::runtime_error("Model is not supported: " + FLAGS_model_name);
     }
 
-	// Set Workload Attributes
-	std::vector<std::string> in_blobs, out_blobs;
-	auto dataset_name = workload->get_dataset_name();
-    auto workload_name = workload->get_workload_name();
-	in_blobs = workload->get_input_names();
-	out_blobs = workload->get_output_names();
-
     if (dataset_name == mlperf_ov::DatasetName::ImageNet2012) {
         ov_qsl = std::unique_ptr<Imagenet>(new Imagenet(settings, image_width, image_height,
                         num_channels, FLAGS_data_path, image_format,
@@ -142,6 +170,8 @@ int main(int argc, char **argv) {
         std::cout << "    [INFO] Total Sample Count: " << ov_qsl->TotalSampleCount() << std::endl;
     }
 
+    ov_qsl->set_load_threads(FLAGS_load_threads);
+
     if (settings.mode != mlperf::TestMode::AccuracyOnly) {
         std::cout << "    [INFO] Performance Sample Count: " << ov_qsl->PerformanceSampleCount() << std::endl;
     }
@@ -151,27 +181,169 @@ int main(int argc, char **argv) {
     ov_properties.device = FLAGS_device;
     ov_properties.nstreams = FLAGS_nstreams;
     ov_properties.nthreads = FLAGS_nthreads;
+    ov_properties.nireq = FLAGS_nireq;
+    if (FLAGS_nireq_max > 0) {
+        if (settings.scenario != mlperf::TestScenario::Server) {
+            std::cout << "    [WARNING] --nireq_max is only supported for Server and is ignored" << std::endl;
+        } else if (FLAGS_nireq_min > FLAGS_nireq_max) {
+            throw std::runtime_error("--nireq_min must not exceed --nireq_max");
+        } else {
+            ov_properties.nireq_min = std::max(FLAGS_nireq_min, 1u);
+            ov_properties.nireq_max = FLAGS_nireq_max;
+        }
+    }
     ov_properties.infer_precision = FLAGS_infer_precision;
     ov_properties.allow_auto_batching = FLAGS_allow_auto_batching;
     ov_properties.extensions = FLAGS_extensions;
+    ov_properties.pp_threads = FLAGS_pp_threads;
+    ov_properties.pp_cores = FLAGS_pp_cores;
+    ov_properties.cache_dir = FLAGS_model_cache_dir;
+    ov_properties.mmap_weights = FLAGS_mmap_weights;
+    ov_properties.prebind_inputs = FLAGS_prebind_inputs;
+    if (FLAGS_ingraph_topk) {
+        if (workload_name != mlperf_ov::WorkloadName::ResNet50) {
+            throw std::runtime_error("--ingraph_topk is only supported for resnet50");
+        }
+        ov_properties.ingraph_topk = true;
+    }
+    if (FLAGS_graph_preprocess) {
+        if (dataset_name == mlperf_ov::DatasetName::SQuAD_v1_1) {
+            throw std::runtime_error("--graph_preprocess is only supported for resnet50 and retinanet");
+        }
+        // At the model size the host resize is the only one; the graph converts type, color and layout
+        ov_properties.graph_preprocess_size = FLAGS_graph_preprocess_size > 0 ? FLAGS_graph_preprocess_size : image_width;
+        static_cast<ImageDataset*>(ov_qsl.get())->set_graph_preprocess(ov_properties.graph_preprocess_size);
+    }
+    if (!FLAGS_sample_cache_dir.empty()) {
+        if (dataset_name == mlperf_ov::DatasetName::SQuAD_v1_1) {
+            throw std::runtime_error("--sample_cache_dir is only supported for resnet50 and retinanet");
+        }
+        static_cast<ImageDataset*>(ov_qsl.get())->set_sample_cache(FLAGS_sample_cache_dir);
+    }
+    if (!FLAGS_seq_buckets.empty()) {
+        if (workload_name != mlperf_ov::WorkloadName::Bert) {
+            throw std::runtime_error("--seq_buckets is only supported for bert");
+        }
+        if (settings.scenario == mlperf::TestScenario::SingleStream) {
+            std::cout << "    [WARNING] --seq_buckets is ignored for SingleStream" << std::endl;
+        } else {
+            ov_properties.seq_buckets = SeqBuckets::parse(FLAGS_seq_buckets, max_seq_length);
+            if (ov_properties.prebind_inputs) {
+                // Request-owned tensors need a static shape
+                std::cout << "    [WARNING] --prebind_inputs is ignored with --seq_buckets" << std::endl;
+                ov_properties.prebind_inputs = false;
+            }
+        }
+    }
 
-    // Init SUT
-    if (settings.scenario == mlperf::TestScenario::SingleStream) {
-        ov_sut = std::unique_ptr<SUTBase>(new SUTBase(settings, ov_qsl.get(), ov_properties, FLAGS_batch_size,
-                    FLAGS_dataset, FLAGS_model_name, in_blobs, out_blobs, FLAGS_model_path, post_processor));
-    } else if (settings.scenario == mlperf::TestScenario::Offline) {
-        ov_sut = std::unique_ptr<SUTOffline>(new SUTOffline(settings, ov_qsl.get(), ov_properties, FLAGS_batch_size,
-                    FLAGS_dataset, FLAGS_model_name, in_blobs, out_blobs, FLAGS_model_path, post_processor));
-    } else if (settings.scenario == mlperf::TestScenario::MultiStream) {
-        ov_sut = std::unique_ptr<SUTMultistream>(new SUTMultistream(settings, ov_qsl.get(), ov_properties, FLAGS_batch_size,
-                    FLAGS_dataset, FLAGS_model_name, in_blobs, out_blobs, FLAGS_model_path, post_processor));
-     } else if (settings.scenario == mlperf::TestScenario::Server) {
-        ov_sut = std::unique_ptr<SUTServer>(new SUTServer(settings, ov_qsl.get(), ov_properties, FLAGS_batch_size,
-                    FLAGS_dataset, FLAGS_model_name, in_blobs, out_blobs, FLAGS_model_path, post_processor));
+    if (FLAGS_dynamic_batch) {
+        if (settings.scenario != mlperf::TestScenario::Offline &&
+                settings.scenario != mlperf::TestScenario::MultiStream) {
+            std::cout << "    [WARNING] --dynamic_batch is only supported for Offline and MultiStream and is ignored" << std::endl;
+        } else {
+            ov_properties.dynamic_batch = true;
+            if (ov_properties.prebind_inputs) {
+                // Request-owned tensors need a static shape
+                std::cout << "    [WARNING] --prebind_inputs is ignored with --dynamic_batch" << std::endl;
+                ov_properties.prebind_inputs = false;
+            }
+        }
+    }
+    if (FLAGS_zero_copy_outputs) {
+        if (workload_name != mlperf_ov::WorkloadName::Bert) {
+            throw std::runtime_error("--zero_copy_outputs is only supported for bert");
+        }
+        if (!ov_properties.seq_buckets.empty() || ov_properties.dynamic_batch) {
+            // Bucketed responses are padded to the full length and dynamic outputs have no fixed size
+            std::cout << "    [WARNING] --zero_copy_outputs is ignored with --seq_buckets and --dynamic_batch" << std::endl;
+        } else {
+            ov_properties.zero_copy_outputs = true;
+        }
+    }
+    if (FLAGS_numa_instances > 1) {
+        if (settings.scenario != mlperf::TestScenario::Offline) {
+            std::cout << "    [WARNING] --numa_instances is only supported for Offline and is ignored" << std::endl;
+        } else {
+            std::vector<NumaNode> nodes = numa_nodes();
+            if (nodes.size() < FLAGS_numa_instances) {
+                throw std::runtime_error("--numa_instances " + std::to_string(FLAGS_numa_instances) +
+                                         " needs as many NUMA nodes with cores, found " + std::to_string(nodes.size()));
+            }
+            for (size_t i = 0; i < FLAGS_numa_instances; ++i) {
+                std::cout << "    [INFO] Backend instance " << i << " on NUMA node " << nodes[i].id << " ("
+                          << nodes[i].cores.size() << " cores)" << std::endl;
+                ov_properties.instance_cores.push_back(nodes[i].cores);
+            }
+            ov_qsl->set_numa_shards(ov_properties.instance_cores, FLAGS_batch_size);
+        }
+    }
+
+    ServerProperties server_properties;
+    server_properties.dispatch_threads = FLAGS_dispatch_threads;
+    server_properties.batching_latency_fraction = FLAGS_batching_latency_fraction;
+    server_properties.elastic_interval_ms = FLAGS_elastic_interval_ms;
+
+    SingleStreamProperties ss_properties;
+    ss_properties.cores = FLAGS_ss_cores;
+    ss_properties.busy_poll = FLAGS_ss_busy_poll;
+
+    WarmupProperties warmup_properties;
+    warmup_properties.min_rounds = FLAGS_warmup_iters;
+    warmup_properties.max_rounds = std::max(FLAGS_warmup_max_iters, FLAGS_warmup_iters);
+    warmup_properties.window = std::max(1u, FLAGS_warmup_window);
+    warmup_properties.max_cv = FLAGS_warmup_cv;
+
+    // Short performance runs of one configuration, shared by AutoTune and PrecisionAB
+    AutoTuner::TrialFunction run_trial = [&](const TuneConfig& config, const mlperf::TestSettings& trial_settings,
+                                             const mlperf::LogSettings& trial_log_settings) {
+        OVBackendProperties trial_properties = ov_properties;
+        trial_properties.nstreams = config.nstreams;
+        trial_properties.nthreads = config.nthreads;
+        trial_properties.nireq = config.nireq;
+        if (!config.infer_precision.empty()) {
+            trial_properties.infer_precision = config.infer_precision;
+        }
+        std::unique_ptr<SUTInterface> trial_sut = create_sut(trial_settings, ov_qsl.get(), trial_properties,
+                                                             config.batch_size, server_properties, ss_properties);
+        if (FLAGS_warmup_iters > 0) {
+            trial_sut->WarmUp(warmup_properties);
+        }
+        mlperf::StartTest(reinterpret_cast<mlperf::SystemUnderTest*>(trial_sut.get()),
+                          reinterpret_cast<mlperf::QuerySampleLibrary*>(ov_qsl.get()),
+                          trial_settings, trial_log_settings, "");
+    };
+
+    if (FLAGS_mode == "AutoTune") {
+        AutoTuner tuner(settings, log_settings, FLAGS_model_name, FLAGS_scenario,
+                        FLAGS_autotune_duration_ms, FLAGS_autotune_qps_steps);
+        auto configs = tuner.search_space(FLAGS_autotune_nstreams, FLAGS_autotune_nthreads,
+                                          FLAGS_autotune_nireq, FLAGS_autotune_batch_size);
+        tuner.run(configs, run_trial);
+        std::cout << "    [INFO] AutoTune Completed" << trail_space << "\n";
+        return 0;
+    }
+
+    if (FLAGS_mode == "PrecisionAB") {
+        TuneConfig base_config;
+        base_config.nstreams = ov_properties.nstreams;
+        base_config.nthreads = ov_properties.nthreads;
+        base_config.nireq = ov_properties.nireq;
+        base_config.batch_size = FLAGS_batch_size;
+        PrecisionABOptions ab_options;
+        ab_options.precisions = FLAGS_ab_precisions;
+        ab_options.accuracy_samples = FLAGS_ab_accuracy_samples;
+        ab_options.duration_ms = FLAGS_ab_duration_ms;
+        run_precision_ab(settings, log_settings, ov_qsl.get(), ov_properties, base_config, FLAGS_model_name,
+                         FLAGS_scenario, FLAGS_model_path, ab_options, run_trial);
+        std::cout << "    [INFO] PrecisionAB Completed" << trail_space << "\n";
+        return 0;
     }
+
+    // Init SUT
+    ov_sut = create_sut(settings, ov_qsl.get(), ov_properties, FLAGS_batch_size, server_properties, ss_properties);
     if (FLAGS_warmup_iters > 0) {
         std::cout << "    [INFO] Warming up \n";
-        ov_sut->WarmUp(FLAGS_warmup_iters);
+        ov_sut->WarmUp(warmup_properties);
     }
 
     std::cout << "    [INFO] Starting " << FLAGS_mode << "Benchmark\n";
@@ -179,6 +351,8 @@ int main(int argc, char **argv) {
                       reinterpret_cast<mlperf::QuerySampleLibrary*>(ov_qsl.get()),
                       settings, log_settings, FLAGS_audit_conf);
     std::cout << "    [INFO] Benchmark Completed" << trail_space << "\n";
+    ov_sut->Report();
+    alloc_counter::report();
 
     return 0;
 }
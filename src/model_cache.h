@@ -0,0 +1,154 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <openvino/openvino.hpp>
+
+/// @brief On-disk cache of compiled model blobs.
+///
+/// Blobs are written with CompiledModel::export_model() and read back with
+/// Core::import_model(). The key hashes the model files together with every
+/// option that changes the compiled result (device, batch, performance hint,
+/// streams, threads, precision, input types and the OpenVINO build). Each blob has a
+/// sidecar with the time its compilation took, which is reported as saved
+/// startup time on later hits.
+class CompiledModelCache final {
+public:
+    explicit CompiledModelCache(const std::string& cache_dir) : cache_dir_(cache_dir) {
+        boost::filesystem::create_directories(cache_dir_);
+    }
+
+    /// Builds the cache key from the model files and a description of the compile options.
+    std::string make_key(const std::string& model_path, const std::string& compile_options) const {
+        uint64_t hash = kFnvOffset;
+        hash_file(model_path, hash);
+        boost::filesystem::path weights(model_path);
+        if (weights.extension() == ".xml") {
+            weights.replace_extension(".bin");
+            if (boost::filesystem::exists(weights)) {
+                hash_file(weights.string(), hash);
+            }
+        }
+        hash_bytes(compile_options.data(), compile_options.size(), hash);
+        std::string version = ov::get_openvino_version().buildNumber;
+        hash_bytes(version.data(), version.size(), hash);
+
+        std::stringstream key;
+        key << boost::filesystem::path(model_path).stem().string() << "_"
+            << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return key.str();
+    }
+
+    /// Imports a cached blob. Returns false on a miss or an unreadable blob.
+    bool import(const std::string& key, ov::Core& core, const std::string& device,
+                const ov::AnyMap& config, ov::CompiledModel& compiled_model) {
+        std::ifstream blob(blob_path(key), std::ios::binary);
+        if (!blob) {
+            std::cout << "    [INFO] Model cache miss: " << key << std::endl;
+            return false;
+        }
+        auto start = std::chrono::steady_clock::now();
+        try {
+            compiled_model = core.import_model(blob, device, config);
+        } catch (const std::exception& e) {
+            std::cout << "    [WARNING] Model cache entry " << key << " could not be imported: " << e.what() << std::endl;
+            return false;
+        }
+        double import_ms = elapsed_ms(start);
+        double compile_ms = read_compile_time(key);
+        std::cout << "    [INFO] Model cache hit: " << key << ", imported in " << std::fixed << std::setprecision(1)
+                  << import_ms << " ms";
+        if (compile_ms > 0) {
+            std::cout << ", saved " << compile_ms - import_ms << " ms of " << compile_ms << " ms compilation";
+        }
+        std::cout << std::endl;
+        return true;
+    }
+
+    /// Stores a freshly compiled model. Failures only disable caching for this run.
+    void store(const std::string& key, const ov::CompiledModel& compiled_model, double compile_ms) {
+        std::string path = blob_path(key);
+        std::string tmp_path = path + ".tmp";
+        try {
+            {
+                std::ofstream blob(tmp_path, std::ios::binary);
+                compiled_model.export_model(blob);
+                if (!blob) {
+                    throw std::runtime_error("write failed");
+                }
+            }
+            // Rename last so concurrent runs never import a partially written blob
+            std::ofstream(meta_path(key)) << compile_ms << std::endl;
+            boost::filesystem::rename(tmp_path, path);
+            std::cout << "    [INFO] Model cache stored: " << key << std::endl;
+        } catch (const std::exception& e) {
+            std::remove(tmp_path.c_str());
+            std::cout << "    [WARNING] Model cache entry " << key << " could not be stored: " << e.what() << std::endl;
+        }
+    }
+
+    static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    static constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+    static constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+    // FNV-1a over 8-byte words keeps hashing multi-GB weights well below compile time
+    static void hash_bytes(const char* data, size_t size, uint64_t& hash) {
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash = (hash ^ word) * kFnvPrime;
+        }
+        for (; i < size; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * kFnvPrime;
+        }
+        hash = (hash ^ size) * kFnvPrime;
+    }
+
+    static void hash_file(const std::string& path, uint64_t& hash) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Cannot read model file for cache key: " + path);
+        }
+        std::vector<char> chunk(1 << 20);
+        while (file) {
+            file.read(chunk.data(), chunk.size());
+            hash_bytes(chunk.data(), static_cast<size_t>(file.gcount()), hash);
+        }
+    }
+
+    double read_compile_time(const std::string& key) const {
+        double compile_ms = 0;
+        std::ifstream meta(meta_path(key));
+        meta >> compile_ms;
+        return compile_ms;
+    }
+
+    std::string blob_path(const std::string& key) const {
+        return (boost::filesystem::path(cache_dir_) / (key + ".blob")).string();
+    }
+
+    std::string meta_path(const std::string& key) const {
+        return (boost::filesystem::path(cache_dir_) / (key + ".meta")).string();
+    }
+
+    std::string cache_dir_;
+};
+
+constexpr uint64_t CompiledModelCache::kFnvOffset;
+constexpr uint64_t CompiledModelCache::kFnvPrime;
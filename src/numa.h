@@ -0,0 +1,66 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "post_processing_pool.h"
+
+struct NumaNode {
+    int id;
+    std::vector<int> cores;
+};
+
+/// @brief Online NUMA nodes that have cores, read from sysfs; empty where unavailable.
+std::vector<NumaNode> numa_nodes() {
+    std::vector<NumaNode> nodes;
+#ifdef __linux__
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string node_list;
+    if (!(online >> node_list)) {
+        return nodes;
+    }
+    // The node list uses the same range format as core lists
+    for (int id : parse_core_list(node_list)) {
+        std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+        std::string cores;
+        // Memory-only nodes have an empty cpulist
+        if (cpulist >> cores) {
+            nodes.push_back(NumaNode{id, parse_core_list(cores)});
+        }
+    }
+#endif
+    return nodes;
+}
+
+/// @brief Pins the calling thread to the given cores for the scope's lifetime and then
+/// restores its previous affinity. No-op for an empty list.
+class ScopedThreadAffinity final {
+public:
+    explicit ScopedThreadAffinity(const std::vector<int>& cores) {
+        if (cores.empty()) {
+            return;
+        }
+#ifdef __linux__
+        restore_ = pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &saved_) == 0;
+#endif
+        pin_current_thread(cores);
+    }
+
+    ~ScopedThreadAffinity() {
+#ifdef __linux__
+        if (restore_) {
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &saved_);
+        }
+#endif
+    }
+
+    ScopedThreadAffinity(const ScopedThreadAffinity&) = delete;
+    ScopedThreadAffinity& operator=(const ScopedThreadAffinity&) = delete;
+
+private:
+#ifdef __linux__
+    cpu_set_t saved_;
+#endif
+    bool restore_ = false;
+};
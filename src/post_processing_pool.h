@@ -0,0 +1,123 @@
+#pragma once
+
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "blocking_queue.h"
+
+/// @brief Parses a core list such as "0-3,8,10-11" into core ids.
+std::vector<int> parse_core_list(const std::string& cores) {
+    std::vector<int> result;
+    std::stringstream ss(cores);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        auto dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+        if (last < first) {
+            throw std::runtime_error("Invalid core range: " + range);
+        }
+        for (int core = first; core <= last; ++core) {
+            result.push_back(core);
+        }
+    }
+    return result;
+}
+
+/// @brief Pins the calling thread to the given cores. No-op for an empty list.
+void pin_current_thread(const std::vector<int>& cores) {
+    if (cores.empty()) {
+        return;
+    }
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int core : cores) {
+        CPU_SET(core, &cpuset);
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0) {
+        std::cout << "    [WARNING] Failed to pin thread to requested cores" << std::endl;
+    }
+#else
+    std::cout << "    [WARNING] Thread pinning is not supported on this platform" << std::endl;
+#endif
+}
+
+/// @brief Worker threads that run post-processing for completed infer requests.
+///
+/// The OpenVINO completion callback only enqueues the finished request; a worker
+/// then calls Request::run_callback(), which post-processes, reports to loadgen and
+/// returns the request to its idle pool.
+template <typename Request>
+class PostProcessingPool final {
+public:
+    PostProcessingPool(unsigned num_threads, const std::string& cores) :
+            cores_(parse_core_list(cores)) {
+        for (unsigned i = 0; i < num_threads; ++i) {
+            workers_.emplace_back(&PostProcessingPool::WorkerLoop, this);
+        }
+    }
+
+    ~PostProcessingPool() {
+        tasks_.close();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /// Returns nullptr when num_threads is 0 (post-processing stays in the OpenVINO callback).
+    static std::unique_ptr<PostProcessingPool> create(unsigned num_threads, const std::string& cores) {
+        if (num_threads == 0) {
+            return nullptr;
+        }
+        std::cout << "    [INFO] Creating " << num_threads << " post-processing thread(s)";
+        if (!cores.empty()) {
+            std::cout << " on cores " << cores;
+        }
+        std::cout << std::endl;
+        return std::unique_ptr<PostProcessingPool>(new PostProcessingPool(num_threads, cores));
+    }
+
+    PostProcessingPool(const PostProcessingPool&) = delete;
+    PostProcessingPool& operator=(const PostProcessingPool&) = delete;
+
+    void submit(Request* request, const std::exception_ptr& ptr) {
+        tasks_.push(Task{request, ptr});
+    }
+
+    size_t num_threads() const {
+        return workers_.size();
+    }
+
+private:
+    struct Task {
+        Request* request;
+        std::exception_ptr ptr;
+    };
+
+    void WorkerLoop() {
+        pin_current_thread(cores_);
+        Task task;
+        while (tasks_.pop(task)) {
+            task.request->run_callback(task.ptr);
+        }
+    }
+
+    std::vector<int> cores_;
+    BlockingQueue<Task> tasks_;
+    std::vector<std::thread> workers_;
+};
@@ -1,19 +1,23 @@
 #pragma once
 
+#include <algorithm>
+
+#include "item_ov.h"
+#include "response_arena.h"
 #include "utils.h"
 
 namespace Processors {
-void postprocess_ssd_retinanet(Item qitem, ov::InferRequest req,
-        std::vector<float> &result, std::vector<mlperf::ResponseId> &response_ids,
-        unsigned batch_size, std::vector<unsigned> &counts) {
+using OutputPort = ov::Output<const ov::Node>;
+
+void postprocess_ssd_retinanet(const Item &qitem, ov::InferRequest &req,
+        ResponseArena &arena, unsigned batch_size,
+        const OutputPort &boxes, const OutputPort &scores, const OutputPort &labels) {
     cv::Size image_size = {800, 800};
     float score_treshold = 0.05;
 
-    unsigned count = 0;
-
-    auto bbox_tensor = req.get_tensor("boxes");
-    auto scores_tensor = req.get_tensor("scores");
-    auto labels_tensor = req.get_tensor("labels");
+    auto bbox_tensor = req.get_tensor(boxes);
+    auto scores_tensor = req.get_tensor(scores);
+    auto labels_tensor = req.get_tensor(labels);
 
     auto bbox_ptr = bbox_tensor.data<float>();
     auto scores_ptr = scores_tensor.data<float>();
@@ -21,84 +25,106 @@ void postprocess_ssd_retinanet(Item qitem, ov::InferRequest req,
 
     auto prediction_size = scores_tensor.get_shape()[0];
 
-    auto sample_idxs = qitem.sample_idxs_;
-    int kept_indexes = 0;
-    for (int i = 0; i < prediction_size; i++) {
+    size_t kept_indexes = 0;
+    for (size_t i = 0; i < prediction_size; i++) {
+        if (scores_ptr[i] >= score_treshold) {
+            kept_indexes++;
+        }
+    }
+
+    float sample_idx = float(qitem.sample_idxs_[0]);
+    float* result = arena.allocate(7 * kept_indexes);
+    float* out = result;
+    for (size_t i = 0; i < prediction_size; i++) {
         auto score = scores_ptr[i];
         if (score >= score_treshold) {
-            kept_indexes++;
             auto class_inx = labels_ptr[i];
             // box comes from model as: xmin, ymin, xmax, ymax
             // box comes with dimentions in the range of [0, height]
             // and [0, width] respectively. It is necesary to scale
             // them in the range [0, 1]
-            result.push_back(float(sample_idxs[i]));
-            result.push_back(bbox_ptr[i*4 + 1]/image_size.height);
-            result.push_back(bbox_ptr[i*4 + 0]/image_size.width);
-            result.push_back(bbox_ptr[i*4 + 3]/image_size.height);
-            result.push_back(bbox_ptr[i*4 + 2]/image_size.width);
-            result.push_back(score);
-            result.push_back(float(class_inx));
+            *out++ = sample_idx;
+            *out++ = bbox_ptr[i*4 + 1]/image_size.height;
+            *out++ = bbox_ptr[i*4 + 0]/image_size.width;
+            *out++ = bbox_ptr[i*4 + 3]/image_size.height;
+            *out++ = bbox_ptr[i*4 + 2]/image_size.width;
+            *out++ = score;
+            *out++ = float(class_inx);
         }
     }
-    response_ids.push_back(qitem.response_ids_[0]);
-    counts.push_back(7 * kept_indexes);
+    arena.add_response(qitem.response_ids_[0], result, 7 * kept_indexes);
 }
 
-void postprocess_classification(Item qitem, ov::InferRequest req,
-                                 std::vector<float>& results,
-                                 std::vector<mlperf::ResponseId>& response_ids,
+void postprocess_classification(const Item &qitem, ov::InferRequest &req,
+                                 ResponseArena &arena,
                                  unsigned batch_size,
-                                 std::vector<unsigned>& counts,
-                                 const std::string& output_name) {
-    std::vector<unsigned> res;
-    auto out = req.get_tensor(output_name);
-
-    TopResults(1, out, res);
-
-    for (size_t j = 0; j < res.size(); ++j) {
-        results.push_back(static_cast<float>(res[j] - 1));
-        response_ids.push_back(qitem.response_ids_[j]);
-	    counts.push_back(1);
+                                 const OutputPort &output) {
+    auto out = req.get_tensor(output);
+
+    // Padded batch slots have no response id
+    size_t out_batch = out.get_shape()[0];
+    size_t num_samples = std::min<size_t>(out_batch, qitem.response_ids_.size());
+    float* results = arena.allocate(num_samples);
+
+    if (out.get_element_type() == ov::element::i32) {
+        // The graph already reduced the scores to the top-1 index
+        const int32_t* data = out.data<const int32_t>();
+        for (size_t j = 0; j < num_samples; ++j) {
+            results[j] = static_cast<float>(data[j] - 1);
+        }
+    } else if (out.get_element_type() == ov::element::f32) {
+        // Top-1 is a plain argmax; avoids TopResults' per-call index buffers
+        size_t num_classes = out.get_size() / out_batch;
+        const float* data = out.data<const float>();
+        for (size_t j = 0; j < num_samples; ++j) {
+            const float* scores = data + j * num_classes;
+            results[j] = static_cast<float>(std::max_element(scores, scores + num_classes) - scores - 1);
+        }
+    } else {
+        std::vector<unsigned> res;
+        TopResults(1, out, res);
+        for (size_t j = 0; j < num_samples; ++j) {
+            results[j] = static_cast<float>(res[j] - 1);
+        }
     }
-}
 
-void postprocess_resnet50(Item qitem,
-                         ov::InferRequest req,
-                         std::vector<float> &results,
-                         std::vector<mlperf::ResponseId> &response_ids,
-                         unsigned batch_size,
-                         std::vector<unsigned> &counts) {
-    const std::string output_name = "softmax_tensor:0";
-    return postprocess_classification(qitem, req, results, response_ids, batch_size, counts, output_name);
+    for (size_t j = 0; j < num_samples; ++j) {
+        arena.add_response(qitem.response_ids_[j], &results[j], 1);
+    }
 }
 
-void postprocess_bert_common(Item qitem,
-                             ov::InferRequest req,
-                             std::vector<float>& results,
-                             std::vector<mlperf::ResponseId>& response_ids,
+void postprocess_bert_common(const Item &qitem,
+                             ov::InferRequest &req,
+                             ResponseArena &arena,
                              unsigned batch_size,
-                             std::vector<unsigned>& counts,
-                             const std::string& out_0_name,
-                             const std::string& out_1_name) {
-	auto out_0 = req.get_tensor(out_0_name);
-	auto out_1 = req.get_tensor(out_1_name);
-
-	size_t offset = out_0.get_size() / batch_size;
+                             const OutputPort &out_0_port,
+                             const OutputPort &out_1_port,
+                             size_t response_seq_len) {
+	auto out_0 = req.get_tensor(out_0_port);
+	auto out_1 = req.get_tensor(out_1_port);
+
+	// A dynamic-batch model returns only the samples it ran
+	size_t out_batch = out_0.get_shape()[0];
+	size_t offset = out_0.get_size() / out_batch;
+    // Bucketed batches run shorter than the response length; the tail is padded with
+    // logits that can never win, past the feature's tokens
+    size_t response_len = std::max(offset, response_seq_len);
+    static constexpr float kPadLogit = -10000.0f;
 	const float* out_0_data = out_0.data<const float>();
 	const float* out_1_data = out_1.data<const float>();
 
-    size_t n0 = results.size();
-    results.resize(n0 + 2 * out_0.get_size());
+    // Padded batch slots have no response id
+    size_t num_samples = std::min<size_t>(out_batch, qitem.response_ids_.size());
 
-    for (size_t j = 0; j < batch_size; j++) {
-        response_ids.push_back(qitem.response_ids_[j]);
-        for (size_t i = 0, k = 0; i < offset; i++, k += 2) {
-
-            results[n0 + j * offset + k] = out_0_data[i];
-            results[n0 + j * offset + k + 1] = out_1_data[i];
+    for (size_t j = 0; j < num_samples; j++) {
+        float* results = arena.allocate(2 * response_len);
+        size_t k = 0;
+        for (size_t i = 0; i < offset; i++, k += 2) {
+            results[k] = out_0_data[i];
+            results[k + 1] = out_1_data[i];
         }
-		counts.push_back(offset * 2);
+        std::fill(results + k, results + 2 * response_len, kPadLogit);
+        arena.add_response(qitem.response_ids_[j], results, 2 * response_len);
 
 		// Next sample
 		out_0_data += offset;
@@ -106,14 +132,23 @@ void postprocess_bert_common(Item qitem,
 	}
 }
 
-void postprocess_bert(Item qitem,
-                      ov::InferRequest req,
-                      std::vector<float>& results,
-                      std::vector<mlperf::ResponseId>& response_ids,
-                      unsigned batch_size,
-                      std::vector<unsigned>& counts) {
-    const std::string out_0_name = "output_start_logits";
-    const std::string out_1_name = "output_end_logits";
-    return postprocess_bert_common(qitem, req, results, response_ids, batch_size, counts, out_0_name, out_1_name);
+// The request's output is harness memory that already holds the interleaved logits of
+// every sample, so responses point straight into it
+void postprocess_bert_zero_copy(const Item &qitem,
+                                ov::InferRequest &req,
+                                ResponseArena &arena,
+                                unsigned batch_size,
+                                const OutputPort &output) {
+    auto out = req.get_tensor(output);
+
+    size_t out_batch = out.get_shape()[0];
+    size_t response_len = out.get_size() / out_batch;
+    const float* data = out.data<const float>();
+
+    // Padded batch slots have no response id
+    size_t num_samples = std::min<size_t>(out_batch, qitem.response_ids_.size());
+    for (size_t j = 0; j < num_samples; j++) {
+        arena.add_response(qitem.response_ids_[j], data + j * response_len, response_len);
+    }
 }
 };
\ No newline at end of file
@@ -0,0 +1,418 @@
+#pragma once
+
+#include <algorithm>
+#include <iomanip>
+#include <cctype>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "autotune.h"
+#include "backend_ov.h"
+#include "datasets/dataset.h"
+#include "datasets/image_dataset.h"
+#include "datasets/openimages.h"
+#include "datasets/squad.h"
+#include "workload_helpers.h"
+
+// Post-processed outputs of every subset sample, as they would be sent to loadgen
+using SampleOutputs = std::vector<std::vector<float>>;
+
+/// @brief Task metric of a precision on the accuracy subset.
+///
+/// ResNet50 is scored natively as top-1 accuracy against the ImageNet labels, BERT
+/// as SQuAD F1 against the answers exported with the preprocessed features and
+/// RetinaNet as COCO-style mAP against the OpenImages annotations. Without that
+/// ground truth a precision is only scored by its agreement with the reference
+/// precision. Agreement scores are 1 for the reference by construction, so
+/// MLPerf's accuracy targets are not applied to them.
+template <typename Workload>
+struct AccuracyMetric;
+
+template <>
+struct AccuracyMetric<mlperf_ov::ResNet50> {
+    static bool native(QSLBase*) { return true; }
+
+    static std::string name(QSLBase*) { return "top-1 accuracy"; }
+
+    static double compute(const SampleOutputs& outputs, const SampleOutputs&, QSLBase* qsl,
+                          const std::vector<mlperf::QuerySampleIndex>& samples) {
+        auto* images = dynamic_cast<ImageDataset*>(qsl);
+        size_t correct = 0;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            if (!outputs[i].empty() && static_cast<int>(outputs[i][0]) == images->label_list_.at(samples[i])) {
+                ++correct;
+            }
+        }
+        return static_cast<double>(correct) / samples.size();
+    }
+};
+
+template <>
+struct AccuracyMetric<mlperf_ov::Bert> {
+    // Preprocessed files written before answers were exported, or without a vocabulary, only
+    // allow the agreement score
+    static bool native(QSLBase* qsl) {
+        return dynamic_cast<Squad*>(qsl)->HasAnswers();
+    }
+
+    static std::string name(QSLBase* qsl) {
+        if (native(qsl)) {
+            return "SQuAD F1";
+        }
+        return dynamic_cast<Squad*>(qsl)->HasVocabTokens()
+                ? "answer spans matching reference (agreement)"
+                : "answer spans matching reference (agreement; features hold token ids, not vocabulary tokens)";
+    }
+
+    static double compute(const SampleOutputs& outputs, const SampleOutputs& reference, QSLBase* qsl,
+                          const std::vector<mlperf::QuerySampleIndex>& samples) {
+        auto* squad = dynamic_cast<Squad*>(qsl);
+        if (!native(qsl)) {
+            size_t matching = 0;
+            for (size_t i = 0; i < samples.size(); ++i) {
+                if (best_span(outputs[i], squad, samples[i]).second ==
+                        best_span(reference[i], squad, samples[i]).second) {
+                    ++matching;
+                }
+            }
+            return static_cast<double>(matching) / samples.size();
+        }
+
+        // Like the SQuAD decoder, each question is answered by the best span over all of
+        // its features (document windows) in the subset
+        std::map<size_t, std::pair<float, std::string>> predictions;
+        std::map<size_t, mlperf::QuerySampleIndex> answer_samples;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            auto span = best_span(outputs[i], squad, samples[i]);
+            size_t example = squad->GetExampleIndex(samples[i]);
+            auto it = predictions.find(example);
+            if (it == predictions.end() || span.first > it->second.first) {
+                predictions[example] = {span.first, span_text(squad->GetTokens(samples[i]), span.second)};
+                answer_samples[example] = samples[i];
+            }
+        }
+        double f1_sum = 0;
+        for (const auto& prediction : predictions) {
+            double best = 0;
+            for (const auto& answer : squad->GetAnswers(answer_samples[prediction.first])) {
+                best = std::max(best, f1(prediction.second.second, answer));
+            }
+            f1_sum += best;
+        }
+        return predictions.empty() ? 0 : f1_sum / predictions.size();
+    }
+
+    // Highest start + end logit over document spans of at most 30 tokens, as in the SQuAD decoder
+    static std::pair<float, std::pair<size_t, size_t>> best_span(const std::vector<float>& logits, Squad* squad,
+                                                                 mlperf::QuerySampleIndex sample) {
+        static constexpr size_t kMaxAnswerLength = 30;
+        const std::vector<int>& segment_ids = squad->GetSegmentIds(sample);
+        // The last real token is the closing [SEP]
+        size_t num_tokens = std::min(squad->GetSampleLength(sample), logits.size() / 2);
+        num_tokens = num_tokens > 0 ? num_tokens - 1 : 0;
+        std::pair<size_t, size_t> best{0, 0};
+        float best_score = -1e30f;
+        for (size_t start = 0; start < num_tokens; ++start) {
+            if (segment_ids.at(start) != 1) {
+                continue;
+            }
+            for (size_t end = start; end < std::min(num_tokens, start + kMaxAnswerLength); ++end) {
+                float score = logits[2 * start] + logits[2 * end + 1];
+                if (score > best_score) {
+                    best_score = score;
+                    best = {start, end};
+                }
+            }
+        }
+        return {best_score, best};
+    }
+
+    // Joins WordPiece tokens back into words
+    static std::string span_text(const std::vector<std::string>& tokens, std::pair<size_t, size_t> span) {
+        std::string text;
+        for (size_t t = span.first; t <= span.second && t < tokens.size(); ++t) {
+            const std::string& token = tokens[t];
+            if (token.compare(0, 2, "##") == 0) {
+                text += token.substr(2);
+            } else {
+                text += (text.empty() ? "" : " ") + token;
+            }
+        }
+        return text;
+    }
+
+    // SQuAD answer normalization: lower case, no punctuation, no articles, single spaces
+    static std::vector<std::string> normalize(const std::string& text) {
+        std::string cleaned;
+        for (unsigned char c : text) {
+            if (!std::ispunct(c)) {
+                cleaned += static_cast<char>(std::tolower(c));
+            }
+        }
+        std::vector<std::string> words;
+        std::stringstream ss(cleaned);
+        std::string word;
+        while (ss >> word) {
+            if (word != "a" && word != "an" && word != "the") {
+                words.push_back(word);
+            }
+        }
+        return words;
+    }
+
+    static double f1(const std::string& prediction, const std::string& answer) {
+        std::vector<std::string> predicted = normalize(prediction);
+        std::vector<std::string> expected = normalize(answer);
+        std::map<std::string, int> counts;
+        for (const auto& word : expected) {
+            ++counts[word];
+        }
+        size_t common = 0;
+        for (const auto& word : predicted) {
+            if (counts[word]-- > 0) {
+                ++common;
+            }
+        }
+        if (common == 0) {
+            return 0;
+        }
+        double precision = static_cast<double>(common) / predicted.size();
+        double recall = static_cast<double>(common) / expected.size();
+        return 2 * precision * recall / (precision + recall);
+    }
+};
+
+template <>
+struct AccuracyMetric<mlperf_ov::RetinaNet> {
+    // An annotations file without boxes only allows the agreement score
+    static bool native(QSLBase* qsl) {
+        return dynamic_cast<OpenImages*>(qsl)->HasGroundTruth();
+    }
+
+    static std::string name(QSLBase* qsl) {
+        return native(qsl) ? "mAP@[.5:.95] against the OpenImages annotations"
+                           : "reference detections recalled (agreement)";
+    }
+
+    static double compute(const SampleOutputs& outputs, const SampleOutputs& reference, QSLBase* qsl,
+                          const std::vector<mlperf::QuerySampleIndex>& samples) {
+        if (!native(qsl)) {
+            return agreement(outputs, reference, samples);
+        }
+        // COCO averages AP over IoU thresholds 0.50, 0.55, ..., 0.95
+        auto* images = dynamic_cast<OpenImages*>(qsl);
+        double sum = 0;
+        for (int t = 0; t < 10; ++t) {
+            sum += mean_ap(outputs, images, samples, 0.5f + 0.05f * t);
+        }
+        return sum / 10;
+    }
+
+    // Mean over annotated categories of the all-point interpolated AP at one IoU threshold.
+    // Each detection, best score first, matches the unmatched box of its label it overlaps most.
+    static double mean_ap(const SampleOutputs& outputs, OpenImages* images,
+                          const std::vector<mlperf::QuerySampleIndex>& samples, float min_iou) {
+        std::map<int, std::vector<std::pair<float, bool>>> hits;
+        std::map<int, size_t> num_boxes;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            const auto& boxes = images->GetGroundTruth(samples[i]);
+            for (const auto& box : boxes) {
+                ++num_boxes[box.category];
+            }
+            // Detections are [sample, ymin, xmin, ymax, xmax, score, label]
+            std::vector<const float*> detections;
+            for (size_t c = 0; c + 7 <= outputs[i].size(); c += 7) {
+                detections.push_back(&outputs[i][c]);
+            }
+            std::sort(detections.begin(), detections.end(),
+                      [](const float* a, const float* b) { return a[5] > b[5]; });
+            std::vector<bool> matched(boxes.size(), false);
+            for (const float* det : detections) {
+                int label = static_cast<int>(det[6]);
+                int best = -1;
+                float best_iou = min_iou;
+                for (size_t b = 0; b < boxes.size(); ++b) {
+                    const float box[4] = { boxes[b].ymin, boxes[b].xmin, boxes[b].ymax, boxes[b].xmax };
+                    float overlap = matched[b] || boxes[b].category != label ? 0 : iou(box, det + 1);
+                    if (overlap >= best_iou) {
+                        best_iou = overlap;
+                        best = static_cast<int>(b);
+                    }
+                }
+                if (best >= 0) {
+                    matched[best] = true;
+                }
+                hits[label].push_back({det[5], best >= 0});
+            }
+        }
+
+        double ap_sum = 0;
+        for (const auto& category : num_boxes) {
+            auto& ranked = hits[category.first];
+            std::sort(ranked.begin(), ranked.end(),
+                      [](const std::pair<float, bool>& a, const std::pair<float, bool>& b) { return a.first > b.first; });
+            std::vector<double> precision(ranked.size()), recall(ranked.size());
+            size_t true_positives = 0;
+            for (size_t k = 0; k < ranked.size(); ++k) {
+                true_positives += ranked[k].second;
+                precision[k] = static_cast<double>(true_positives) / (k + 1);
+                recall[k] = static_cast<double>(true_positives) / category.second;
+            }
+            for (size_t k = ranked.size(); k > 1; --k) {
+                precision[k - 2] = std::max(precision[k - 2], precision[k - 1]);
+            }
+            double ap = 0, previous_recall = 0;
+            for (size_t k = 0; k < ranked.size(); ++k) {
+                ap += (recall[k] - previous_recall) * precision[k];
+                previous_recall = recall[k];
+            }
+            ap_sum += ap;
+        }
+        return num_boxes.empty() ? 0 : ap_sum / num_boxes.size();
+    }
+
+    static double agreement(const SampleOutputs& outputs, const SampleOutputs& reference,
+                            const std::vector<mlperf::QuerySampleIndex>& samples) {
+        static constexpr float kMinScore = 0.3f;
+        static constexpr float kMinIoU = 0.5f;
+        size_t total = 0, recalled = 0;
+        // Detections are [sample, ymin, xmin, ymax, xmax, score, label]
+        for (size_t i = 0; i < samples.size(); ++i) {
+            for (size_t r = 0; r + 7 <= reference[i].size(); r += 7) {
+                const float* ref = &reference[i][r];
+                if (ref[5] < kMinScore) {
+                    continue;
+                }
+                ++total;
+                for (size_t c = 0; c + 7 <= outputs[i].size(); c += 7) {
+                    const float* det = &outputs[i][c];
+                    if (det[6] == ref[6] && iou(ref + 1, det + 1) >= kMinIoU) {
+                        ++recalled;
+                        break;
+                    }
+                }
+            }
+        }
+        return total == 0 ? 1.0 : static_cast<double>(recalled) / total;
+    }
+
+    static float iou(const float* a, const float* b) {
+        float h = std::min(a[2], b[2]) - std::max(a[0], b[0]);
+        float w = std::min(a[3], b[3]) - std::max(a[1], b[1]);
+        if (h <= 0 || w <= 0) {
+            return 0;
+        }
+        float inter = h * w;
+        return inter / ((a[2] - a[0]) * (a[3] - a[1]) + (b[2] - b[0]) * (b[3] - b[1]) - inter);
+    }
+};
+
+struct PrecisionABOptions {
+    // Precisions to compare; the first is the reference, e.g. "f32,bf16"
+    std::string precisions = "f32,bf16";
+    size_t accuracy_samples = 500;
+    uint32_t duration_ms = 10000;
+};
+
+/// @brief Compares inference precisions by accuracy and performance.
+///
+/// Every precision first runs the accuracy subset synchronously through the
+/// workload's post-processor, then a short loadgen performance run of the
+/// configured scenario. The table lists each precision's metric relative to
+/// the first one and, for native task metrics, flags those below MLPerf's 99%
+/// and 99.9% targets.
+template <typename Workload>
+void RunPrecisionAB(const mlperf::TestSettings& settings,
+                    const mlperf::LogSettings& log_settings,
+                    QSLBase* qsl,
+                    const OVBackendProperties& ov_properties,
+                    const TuneConfig& base_config,
+                    const std::string& model_name,
+                    const std::string& scenario_name,
+                    const std::string& input_model,
+                    const PrecisionABOptions& options,
+                    const AutoTuner::TrialFunction& run_trial) {
+    std::vector<std::string> precisions = split_list(options.precisions);
+    if (precisions.empty()) {
+        throw std::runtime_error("PrecisionAB needs at least one precision");
+    }
+    std::vector<mlperf::QuerySampleIndex> samples;
+    for (size_t i = 0; i < std::min(options.accuracy_samples, qsl->TotalSampleCount()); ++i) {
+        samples.push_back(i);
+    }
+
+    AutoTuner tuner(settings, log_settings, model_name, scenario_name, options.duration_ms, 0, "precision_ab");
+    std::vector<double> accuracies, performance;
+    std::vector<bool> valid;
+    SampleOutputs reference;
+
+    for (const auto& precision : precisions) {
+        std::cout << "    [INFO] PrecisionAB: " << precision << " accuracy on " << samples.size() << " samples" << std::endl;
+        SampleOutputs outputs(samples.size());
+        {
+            // Synchronous batch-1 requests score every sample exactly once
+            mlperf::TestSettings accuracy_settings = settings;
+            accuracy_settings.scenario = mlperf::TestScenario::SingleStream;
+            OVBackendProperties properties = ov_properties;
+            properties.infer_precision = precision;
+            OVBackendBase<Workload> backend(accuracy_settings, properties, 1, input_model);
+            backend.load();
+
+            ResponseArena arena;
+            backend.init_response_arena(arena);
+            Item item;
+            std::vector<mlperf::QuerySampleIndex> sample(1);
+            std::vector<mlperf::ResponseId> response_id(1);
+            qsl->LoadSamplesToRam(samples);
+            for (size_t i = 0; i < samples.size(); ++i) {
+                sample[0] = samples[i];
+                response_id[0] = i;
+                qsl->GetSample(sample, response_id, 1, &item);
+                backend.predict(item, arena);
+                const auto& response = arena.responses()[0];
+                const float* data = reinterpret_cast<const float*>(response.data);
+                outputs[i].assign(data, data + response.size / sizeof(float));
+            }
+            qsl->UnloadSamplesFromRam(samples);
+        }
+        if (reference.empty()) {
+            reference = outputs;
+        }
+        accuracies.push_back(AccuracyMetric<Workload>::compute(outputs, reference, qsl, samples));
+
+        TuneConfig config = base_config;
+        config.infer_precision = precision;
+        bool constraints_met = false;
+        performance.push_back(tuner.measure(config, run_trial, constraints_met));
+        valid.push_back(constraints_met);
+    }
+
+    bool native = AccuracyMetric<Workload>::native(qsl);
+    if (!native) {
+        std::cout << "    [INFO] PrecisionAB: the accuracy column is agreement with " << precisions[0]
+                  << ", not the MLPerf task metric; the 99% and 99.9% targets are not applied" << std::endl;
+    }
+    std::cout << "    [INFO] PrecisionAB (" << AccuracyMetric<Workload>::name(qsl) << ", " << tuner.metric_name()
+              << ", reference " << precisions[0] << "):" << std::endl;
+    std::cout << "         " << std::left << std::setw(10) << "precision" << std::right << std::setw(10) << "accuracy"
+              << std::setw(10) << "relative" << std::setw(14) << "performance" << "  flags" << std::endl;
+    for (size_t p = 0; p < precisions.size(); ++p) {
+        double relative = accuracies[0] > 0 ? accuracies[p] / accuracies[0] : 0;
+        std::stringstream flags;
+        if (native && relative < 0.99) {
+            flags << " BELOW-99%";
+        } else if (native && relative < 0.999) {
+            flags << " BELOW-99.9%";
+        }
+        if (!valid[p]) {
+            flags << " CONSTRAINTS-NOT-MET";
+        }
+        std::cout << "         " << std::left << std::setw(10) << precisions[p] << std::right << std::fixed
+                  << std::setprecision(4) << std::setw(10) << accuracies[p] << std::setprecision(2)
+                  << std::setw(9) << 100 * relative << "%" << std::setw(14) << performance[p]
+                  << " " << flags.str() << std::endl;
+    }
+}
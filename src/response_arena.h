@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "query_sample.h"
+
+/// @brief Fixed-capacity response storage owned by one inference request.
+///
+/// Capacity is reserved once from the workload's maximum output per batch.
+/// Post-processors take float slots with allocate() and publish them with
+/// add_response(); clear() rewinds the arena without freeing memory, so the
+/// steady state performs no heap allocation. In zero-copy mode the request's
+/// outputs are already laid out as responses and post-processors publish
+/// slices of them directly.
+class ResponseArena final {
+public:
+    ResponseArena() = default;
+
+    void reserve(size_t max_floats, size_t max_responses) {
+        data_.resize(max_floats);
+        responses_.resize(max_responses);
+        used_floats_ = 0;
+        num_responses_ = 0;
+    }
+
+    float* allocate(size_t num_floats) {
+        if (used_floats_ + num_floats > data_.size()) {
+            throw std::runtime_error("Response arena overflow: requested " + std::to_string(num_floats) +
+                                     " floats, " + std::to_string(data_.size() - used_floats_) + " left");
+        }
+        float* ptr = data_.data() + used_floats_;
+        used_floats_ += num_floats;
+        return ptr;
+    }
+
+    void add_response(mlperf::ResponseId id, const float* data, size_t num_floats) {
+        if (num_responses_ == responses_.size()) {
+            throw std::runtime_error("Response arena overflow: more than " +
+                                     std::to_string(responses_.size()) + " responses");
+        }
+        responses_[num_responses_++] = mlperf::QuerySampleResponse{
+            id, reinterpret_cast<std::uintptr_t>(data), sizeof(float) * num_floats };
+    }
+
+    mlperf::QuerySampleResponse* responses() {
+        return responses_.data();
+    }
+
+    size_t num_responses() const {
+        return num_responses_;
+    }
+
+    void clear() {
+        used_floats_ = 0;
+        num_responses_ = 0;
+    }
+
+    void set_zero_copy(bool zero_copy) {
+        zero_copy_ = zero_copy;
+    }
+
+    bool zero_copy() const {
+        return zero_copy_;
+    }
+
+private:
+    std::vector<float> data_;
+    std::vector<mlperf::QuerySampleResponse> responses_;
+    size_t used_floats_ = 0;
+    size_t num_responses_ = 0;
+    bool zero_copy_ = false;
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// @brief Sequence-length buckets for padded token inputs (BERT).
+///
+/// A sample runs at the length of the smallest bucket that holds its real
+/// tokens instead of at the full padded length. Lengths are sorted and the
+/// last one is the model's maximum sequence length, so every sample fits.
+/// Per-bucket counters are updated by the dispatching threads and printed by
+/// report() together with the padding waste and the throughput gain estimated
+/// from the warm-up batch timings.
+class SeqBuckets final {
+public:
+    explicit SeqBuckets(const std::vector<size_t>& lengths = {}) :
+            lengths_(lengths),
+            counters_(new Counters[lengths.size()]) {}
+
+    SeqBuckets(const SeqBuckets&) = delete;
+    SeqBuckets& operator=(const SeqBuckets&) = delete;
+
+    /// Parses a comma-separated list, sorts it and appends max_length if it is missing.
+    static std::vector<size_t> parse(const std::string& list, size_t max_length) {
+        std::vector<size_t> lengths;
+        std::stringstream ss(list);
+        std::string value;
+        while (std::getline(ss, value, ',')) {
+            if (value.empty()) {
+                continue;
+            }
+            size_t length = std::stoul(value);
+            if (length == 0 || length > max_length) {
+                throw std::invalid_argument("Sequence bucket " + value + " must be in [1, " +
+                                            std::to_string(max_length) + "]");
+            }
+            lengths.push_back(length);
+        }
+        if (lengths.empty()) {
+            return lengths;
+        }
+        std::sort(lengths.begin(), lengths.end());
+        lengths.erase(std::unique(lengths.begin(), lengths.end()), lengths.end());
+        if (lengths.back() != max_length) {
+            lengths.push_back(max_length);
+        }
+        return lengths;
+    }
+
+    bool enabled() const { return !lengths_.empty(); }
+
+    size_t size() const { return lengths_.size(); }
+
+    size_t length(size_t bucket) const { return lengths_[bucket]; }
+
+    size_t max_length() const { return lengths_.back(); }
+
+    size_t bucket_of(size_t seq_length) const {
+        return std::lower_bound(lengths_.begin(), lengths_.end() - 1, seq_length) - lengths_.begin();
+    }
+
+    /// Counts one batch of num_samples real samples holding num_tokens real tokens.
+    void record_batch(size_t bucket, size_t batch_size, size_t num_samples, size_t num_tokens) {
+        Counters& counters = counters_[bucket];
+        counters.batches.fetch_add(1, std::memory_order_relaxed);
+        counters.slots.fetch_add(batch_size, std::memory_order_relaxed);
+        counters.samples.fetch_add(num_samples, std::memory_order_relaxed);
+        counters.tokens.fetch_add(num_tokens, std::memory_order_relaxed);
+    }
+
+    /// Drops the batches counted so far, e.g. those of a warm-up.
+    void reset_counts() {
+        for (size_t b = 0; b < lengths_.size(); ++b) {
+            counters_[b].batches = 0;
+            counters_[b].slots = 0;
+            counters_[b].samples = 0;
+            counters_[b].tokens = 0;
+        }
+    }
+
+    /// Latency of one full batch at this bucket's length, measured during warm-up.
+    void set_batch_ms(size_t bucket, double ms) {
+        counters_[bucket].batch_ms = ms;
+    }
+
+    void report(size_t batch_size) const {
+        uint64_t total_samples = 0, total_tokens = 0, total_padded = 0;
+        double bucketed_ms = 0;
+        bool timed = true;
+
+        std::cout << "    [INFO] Sequence buckets (batch " << batch_size << "):" << std::endl;
+        for (size_t b = 0; b < lengths_.size(); ++b) {
+            const Counters& counters = counters_[b];
+            uint64_t batches = counters.batches.load();
+            uint64_t samples = counters.samples.load();
+            uint64_t tokens = counters.tokens.load();
+            uint64_t padded = counters.slots.load() * lengths_[b];
+            total_samples += samples;
+            total_tokens += tokens;
+            total_padded += padded;
+            bucketed_ms += batches * counters.batch_ms;
+            timed = timed && counters.batch_ms > 0;
+
+            std::cout << "         bucket " << std::setw(4) << lengths_[b] << ": " << samples << " samples in "
+                      << batches << " batches, padding waste " << std::fixed << std::setprecision(1)
+                      << waste_percent(tokens, padded) << "%";
+            if (counters.batch_ms > 0) {
+                std::cout << ", " << std::setprecision(2) << counters.batch_ms << " ms/batch";
+            }
+            std::cout << std::endl;
+        }
+        if (total_samples == 0) {
+            return;
+        }
+
+        std::cout << "    [INFO] Padding waste " << std::fixed << std::setprecision(1)
+                  << waste_percent(total_tokens, total_padded) << "% bucketed vs "
+                  << waste_percent(total_tokens, total_samples * max_length()) << "% at " << max_length() << " tokens";
+        if (timed && bucketed_ms > 0) {
+            // Without buckets every sample would run in a full batch at the maximum length
+            double padded_ms = static_cast<double>(total_samples) / batch_size * counters_[lengths_.size() - 1].batch_ms;
+            std::cout << ", estimated throughput gain " << std::setprecision(2) << padded_ms / bucketed_ms
+                      << "x from warm-up batch timings";
+        }
+        std::cout << std::endl;
+    }
+
+private:
+    struct Counters {
+        std::atomic<uint64_t> batches{0};
+        std::atomic<uint64_t> slots{0};
+        std::atomic<uint64_t> samples{0};
+        std::atomic<uint64_t> tokens{0};
+        double batch_ms = 0;
+    };
+
+    static double waste_percent(uint64_t tokens, uint64_t padded) {
+        return padded == 0 ? 0.0 : 100.0 * (padded - tokens) / padded;
+    }
+
+    std::vector<size_t> lengths_;
+    std::unique_ptr<Counters[]> counters_;
+};
@@ -5,16 +5,28 @@
 #include <mutex>
 
 // loadgen
+#include "allocation_counter.h"
 #include "backend_ov.h"
 #include "bindings/c_api.h"
 #include "item_ov.h"
 #include "loadgen.h"
+#include "seq_buckets.h"
+#include "warmup.h"
 #include "query_sample.h"
 #include "query_sample_library.h"
 #include "system_under_test.h"
 #include "test_settings.h"
 
-class SUTBase : public mlperf::SystemUnderTest {
+/// @brief Workload-independent view of a SUT, used by main to warm up and run it.
+class SUTInterface : public mlperf::SystemUnderTest {
+public:
+    virtual void WarmUp(const WarmupProperties& properties) = 0;
+    // Prints SUT statistics once the test is over
+    virtual void Report() {}
+};
+
+template <typename Workload>
+class SUTBase : public SUTInterface {
  public:
     SUTBase(mlperf::TestSettings settings,
             QSLBase* ov_qsl,
@@ -22,26 +34,23 @@ class SUTBase : public mlperf::SystemUnderTest {
             int batch_size,        // Batch size
             std::string dataset,
             std::string workload,
-            std::vector<std::string> input_blob_names,
-            std::vector<std::string> output_blob_names,
             std::string input_model,
-            PPFunction post_processor,
             bool async = false)
         : settings_(settings),
         ov_qsl_(ov_qsl),
         ov_properties_(ov_properties),
         batch_size_(batch_size),
-        workload_(workload) {
+        workload_(workload),
+        seq_buckets_(ov_properties.seq_buckets) {
             if (async) {
-                backend_ov_async_ = std::unique_ptr<OVBackendAsync>(new OVBackendAsync(
-                    settings, ov_properties, batch_size, workload, input_blob_names, output_blob_names,
-                    input_model, post_processor));
+                backend_ov_async_ = std::unique_ptr<OVBackendAsync<Workload>>(new OVBackendAsync<Workload>(
+                    settings, ov_properties, batch_size, input_model));
                 backend_ov_async_->load();
             } else {
-                backend_ov_ = std::unique_ptr<OVBackendBase>(new OVBackendBase(
-                    settings, ov_properties, batch_size, workload, input_blob_names, output_blob_names,
-                    input_model, post_processor));
+                backend_ov_ = std::unique_ptr<OVBackendBase<Workload>>(new OVBackendBase<Workload>(
+                    settings, ov_properties, batch_size, input_model));
                 backend_ov_->load();
+                backend_ov_->init_response_arena(arena_);
             }
         comm_count_ = 1;
     }
@@ -50,53 +59,199 @@ class SUTBase : public mlperf::SystemUnderTest {
         return name;
     }
 
-    virtual void WarmUp(size_t nwarmup_iters) {
-        std::vector<mlperf::QuerySampleIndex> samples;
-        std::vector<mlperf::ResponseId> response_ids;
+    void WarmUp(const WarmupProperties& properties) override {
+        WarmUpSingleRequest(properties, [this](Item& item) { backend_ov_->warmup(item); });
+    }
+
+    void IssueQuery(const std::vector<mlperf::QuerySample>& samples) override {
+        ALLOCATION_SCOPE();
+        CopyQuerySamples(samples, 1);
+        ov_qsl_->GetSample(sample_idxs_, response_ids_, 1, &qitem_);
+
+        RunOneItem();
+    }
 
-        for (size_t i = 0; i < batch_size_; ++i) {
-            samples.push_back(0);
-            response_ids.push_back(1);
+    void FlushQueries() override { return; }
+
+    void Report() override {
+        backend()->report_input_binding();
+        if (seq_buckets_.enabled()) {
+            seq_buckets_.report(batch_size_);
         }
+    }
 
-        ov_qsl_->LoadSamplesToRam(samples);
-        std::vector<float> results;
-        std::vector<unsigned> counts;
+protected:
+    // Refills the reusable sample/id scratch vectors from the first num_samples samples
+    void CopyQuerySamples(const std::vector<mlperf::QuerySample>& samples, size_t num_samples) {
+        alloc_counter::count_query();
+        sample_idxs_.clear();
+        response_ids_.clear();
+        for (size_t i = 0; i < num_samples; ++i) {
+            sample_idxs_.push_back(samples[i].index);
+            response_ids_.push_back(samples[i].id);
+        }
+    }
 
-        for (size_t i = 0; i < nwarmup_iters; ++i) {
-            ov_qsl_->GetSample(samples, response_ids, 1, &qitem_);
-            backend_ov_->warmup(qitem_);
+    OVBackendBase<Workload>* backend() {
+        return backend_ov_async_ ? static_cast<OVBackendBase<Workload>*>(backend_ov_async_.get()) : backend_ov_.get();
+    }
+
+    // Stable counting sort of sample_idxs_/response_ids_ by sequence bucket, so every
+    // bucket is one contiguous range ending at bucket_ends_[bucket]
+    void BucketQuerySamples() {
+        size_t num_samples = sample_idxs_.size();
+        sample_buckets_.resize(num_samples);
+        bucket_ends_.assign(seq_buckets_.size(), 0);
+        for (size_t i = 0; i < num_samples; ++i) {
+            sample_buckets_[i] = seq_buckets_.bucket_of(ov_qsl_->GetSampleLength(sample_idxs_[i]));
+            ++bucket_ends_[sample_buckets_[i]];
         }
-        ov_qsl_->UnloadSamplesFromRam(samples);
+        for (size_t b = 1; b < bucket_ends_.size(); ++b) {
+            bucket_ends_[b] += bucket_ends_[b - 1];
+        }
+
+        bucketed_idxs_.resize(num_samples);
+        bucketed_ids_.resize(num_samples);
+        for (size_t i = num_samples; i-- > 0;) {
+            size_t pos = --bucket_ends_[sample_buckets_[i]];
+            bucketed_idxs_[pos] = sample_idxs_[i];
+            bucketed_ids_[pos] = response_ids_[i];
+        }
+        // The placement loop left each entry at its bucket's start; shift to the ends
+        for (size_t b = 0; b + 1 < bucket_ends_.size(); ++b) {
+            bucket_ends_[b] = bucket_ends_[b + 1];
+        }
+        bucket_ends_.back() = num_samples;
+        sample_idxs_.swap(bucketed_idxs_);
+        response_ids_.swap(bucketed_ids_);
     }
 
-    void IssueQuery(const std::vector<mlperf::QuerySample>& samples) override {
-        std::vector<mlperf::QuerySampleResponse> responses;
-        std::vector<mlperf::QuerySampleIndex> sample_idxs{(samples[0].index)};
-        std::vector<mlperf::ResponseId> response_ids{(samples[0].id)};
+    // Calls run(bucket, begin, count) for every batch of the bucketed query samples
+    template <typename Run>
+    void ForEachBucketBatch(Run run) {
+        size_t begin = 0;
+        for (size_t b = 0; b < bucket_ends_.size(); ++b) {
+            for (; begin < bucket_ends_[b]; begin += batch_size_) {
+                run(b, begin, std::min<size_t>(batch_size_, bucket_ends_[b] - begin));
+            }
+        }
+    }
+
+    // Fills one batch at the bucket's length and counts its padding
+    void GetBucketBatch(const std::vector<mlperf::QuerySampleIndex>& sample_idxs,
+                        const std::vector<mlperf::ResponseId>& response_ids,
+                        size_t bucket, size_t begin, size_t count, Item* item) {
+        ov_qsl_->GetSamplesBucket(sample_idxs, response_ids, begin, count, batch_size_,
+                                  bucket, seq_buckets_.length(bucket), item);
+        size_t num_tokens = 0;
+        for (size_t i = begin; i < begin + count; ++i) {
+            num_tokens += ov_qsl_->GetSampleLength(sample_idxs[i]);
+        }
+        seq_buckets_.record_batch(bucket, batch_size_, count, num_tokens);
+    }
 
-        int num_batches = samples.size() / batch_size_;
-        ov_qsl_->GetSample(sample_idxs, response_ids, 1, &qitem_);
+    // Fills the batch of a query starting at begin, usually its partial last one: unpadded
+    // for a dynamic-batch model, padded to the batch size otherwise
+    void GetTailBatch(const std::vector<mlperf::QuerySampleIndex>& sample_idxs,
+                      const std::vector<mlperf::ResponseId>& response_ids,
+                      size_t begin, size_t count, Item* item) {
+        ov_qsl_->GetSamplesTail(sample_idxs, response_ids, begin, count, batch_size_,
+                                !ov_properties_.dynamic_batch, item);
+    }
 
-        RunOneItem(response_ids);
+    // Warm-up samples 0..count-1, wrapping on datasets smaller than count
+    std::vector<mlperf::QuerySampleIndex> WarmupSamples(size_t count) {
+        std::vector<mlperf::QuerySampleIndex> samples(count);
+        for (size_t i = 0; i < count; ++i) {
+            samples[i] = i % ov_qsl_->TotalSampleCount();
+        }
+        return samples;
     }
 
-    void FlushQueries() override { return; }
+    // Synchronous warm-up: one query per round, cycling through one distinct sample per
+    // round of the convergence window
+    template <typename Run>
+    void WarmUpSingleRequest(const WarmupProperties& properties, Run run) {
+        std::vector<mlperf::QuerySampleIndex> samples = WarmupSamples(properties.window);
+        std::vector<mlperf::QuerySampleIndex> sample(1);
+        std::vector<mlperf::ResponseId> response_id(1, 1);
 
-private:
-    void RunOneItem(std::vector<mlperf::ResponseId> response_id) {
-        std::vector<float> result;
-        std::vector<unsigned> counts;
+        ov_qsl_->LoadSamplesToRam(samples);
+        WarmupMonitor monitor(properties);
+        for (size_t round = 0;; ++round) {
+            auto start = std::chrono::steady_clock::now();
+            sample[0] = samples[round % samples.size()];
+            ov_qsl_->GetSample(sample, response_id, 1, &qitem_);
+            run(qitem_);
+            if (monitor.add_round(WarmupMonitor::elapsed_ms(start))) {
+                break;
+            }
+        }
+        ov_qsl_->UnloadSamplesFromRam(samples);
+        monitor.report();
+    }
+
+    // Asynchronous warm-up: every round runs one batch of every shape (sequence bucket)
+    // on every infer request, with batch_size * nireq distinct samples. Batches rotate
+    // by one per round so requests do not keep seeing the same inputs.
+    // fill(samples, response_ids, batch, shape) returns the Item holding that batch.
+    template <typename Fill>
+    void WarmUpAllRequests(const WarmupProperties& properties, OVBackendBase<Workload>* backend, Fill fill) {
+        size_t nireq = backend->get_nireq();
+        size_t num_shapes = seq_buckets_.enabled() ? seq_buckets_.size() : 1;
+        std::vector<mlperf::QuerySampleIndex> samples = WarmupSamples(batch_size_ * nireq);
+        std::vector<mlperf::ResponseId> response_ids(samples.size(), 1);
+        std::vector<Item*> items(nireq);
+
+        ov_qsl_->LoadSamplesToRam(samples);
+        WarmupMonitor monitor(properties);
+        for (size_t round = 0;; ++round) {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t shape = 0; shape < num_shapes; ++shape) {
+                for (size_t i = 0; i < nireq; ++i) {
+                    items[i] = fill(samples, response_ids, (i + round) % nireq, shape);
+                }
+                backend->run_on_all_requests(items);
+            }
+            if (monitor.add_round(WarmupMonitor::elapsed_ms(start))) {
+                break;
+            }
+        }
+        ov_qsl_->UnloadSamplesFromRam(samples);
+        monitor.report();
+    }
 
-        std::vector<mlperf::QuerySampleResponse> responses;
-        backend_ov_->predict(qitem_, result, response_id, counts);
+    // One warm-up batch of consecutive loaded samples, at the bucket `shape` when enabled
+    void GetWarmupBatch(const std::vector<mlperf::QuerySampleIndex>& samples,
+                        const std::vector<mlperf::ResponseId>& response_ids,
+                        size_t batch, size_t shape, Item* item) {
+        if (seq_buckets_.enabled()) {
+            ov_qsl_->GetSamplesBucket(samples, response_ids, batch * batch_size_, batch_size_, batch_size_,
+                                      shape, seq_buckets_.length(shape), item);
+        } else {
+            ov_qsl_->GetSamplesBatch(samples, response_ids, batch_size_, batch, item);
+        }
+    }
 
-        mlperf::QuerySampleResponse response{
-            response_id[0], reinterpret_cast<std::uintptr_t>(&result[0]),
-            sizeof(float) * counts[0]};
-        responses.push_back(response);
+    // Runs every bucket's shape before the test and times one batch of each for the report
+    void WarmUpBuckets(size_t nwarmup_iters) {
+        std::vector<mlperf::QuerySampleIndex> samples(batch_size_, 0);
+        std::vector<mlperf::ResponseId> response_ids(batch_size_, 1);
 
-        mlperf::QuerySamplesComplete(responses.data(), responses.size());
+        ov_qsl_->LoadSamplesToRam(samples);
+        for (size_t b = 0; b < seq_buckets_.size(); ++b) {
+            ov_qsl_->GetSamplesBucket(samples, response_ids, 0, batch_size_, batch_size_,
+                                      b, seq_buckets_.length(b), &qitem_);
+            seq_buckets_.set_batch_ms(b, backend()->time_infer(qitem_, nwarmup_iters));
+        }
+        ov_qsl_->UnloadSamplesFromRam(samples);
+    }
+
+private:
+    void RunOneItem() {
+        backend_ov_->predict(qitem_, arena_);
+        ALLOCATION_SCOPE_PAUSE();
+        mlperf::QuerySamplesComplete(arena_.responses(), arena_.num_responses());
     }
 
 public:
@@ -105,9 +260,18 @@ public:
     int batch_size_ = 1;
     QSLBase* ov_qsl_;
     std::string workload_;
-    std::unique_ptr<OVBackendBase> backend_ov_;
-    std::unique_ptr<OVBackendAsync> backend_ov_async_;
+    std::unique_ptr<OVBackendBase<Workload>> backend_ov_;
+    std::unique_ptr<OVBackendAsync<Workload>> backend_ov_async_;
     Item qitem_;
     std::vector<Item> qitems_;
+    std::vector<mlperf::QuerySampleIndex> sample_idxs_;
+    std::vector<mlperf::ResponseId> response_ids_;
+    ResponseArena arena_;
     int comm_count_;
+    SeqBuckets seq_buckets_;
+    // Scratch of BucketQuerySamples()
+    std::vector<size_t> sample_buckets_;
+    std::vector<size_t> bucket_ends_;
+    std::vector<mlperf::QuerySampleIndex> bucketed_idxs_;
+    std::vector<mlperf::ResponseId> bucketed_ids_;
 };
\ No newline at end of file
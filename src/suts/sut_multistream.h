@@ -2,7 +2,27 @@
 
 #include "sut_base.h"
 
-class SUTMultistream : public SUTBase {
+template <typename Workload>
+class SUTMultistream : public SUTBase<Workload> {
+protected:
+    using SUTBase<Workload>::settings_;
+    using SUTBase<Workload>::ov_qsl_;
+    using SUTBase<Workload>::batch_size_;
+    using SUTBase<Workload>::backend_ov_async_;
+    using SUTBase<Workload>::qitems_;
+    using SUTBase<Workload>::sample_idxs_;
+    using SUTBase<Workload>::response_ids_;
+    using SUTBase<Workload>::CopyQuerySamples;
+    using SUTBase<Workload>::seq_buckets_;
+    using SUTBase<Workload>::BucketQuerySamples;
+    using SUTBase<Workload>::ForEachBucketBatch;
+    using SUTBase<Workload>::GetBucketBatch;
+    using SUTBase<Workload>::WarmUpBuckets;
+    using SUTBase<Workload>::WarmUpAllRequests;
+    using SUTBase<Workload>::GetWarmupBatch;
+    using SUTBase<Workload>::GetTailBatch;
+    using SUTBase<Workload>::ov_properties_;
+
 public:
     SUTMultistream(mlperf::TestSettings settings,
                    QSLBase* ov_qsl,
@@ -10,66 +30,104 @@ public:
                    int batch_size,
                    std::string dataset,
                    std::string workload,
-                   std::vector<std::string> input_blob_names,
-                   std::vector<std::string> output_blob_names,
-                   std::string input_model,
-                   PPFunction post_processor)
-        : SUTBase(settings, ov_qsl, ov_properties, batch_size, dataset, workload, input_blob_names,
-                output_blob_names, input_model, post_processor, true) {}
+                   std::string input_model)
+        : SUTBase<Workload>(settings, ov_qsl, ov_properties, batch_size, dataset, workload,
+                input_model, true) {}
 
     const std::string& Name() override {
         static const std::string name("OpenVINO MultiStream SUT");
         return name;
     }
 
-    void WarmUp(size_t nwarmup_iters) override {
-        std::vector<mlperf::QuerySampleIndex> samples;
-        std::vector<mlperf::ResponseId> query_ids;
-
-        for (size_t i = 0; i < batch_size_ * backend_ov_async_->get_nireq(); ++i) {
-            samples.push_back(0);
-            query_ids.push_back(1);
+    void WarmUp(const WarmupProperties& properties) override {
+        if (seq_buckets_.enabled()) {
+            WarmUpBuckets(properties.min_rounds);
         }
 
-        ov_qsl_->LoadSamplesToRam(samples);
-        std::cout << " == Starting Warmup ==\n";
-        for (size_t i = 0; i < nwarmup_iters; ++i) {
-            std::vector<mlperf::ResponseId> results_ids;
-            std::vector<mlperf::QuerySampleIndex> sample_idxs;
-
-            std::vector<Item> items;
-            ov_qsl_->GetSamplesBatchedMultistream(samples, query_ids, batch_size_, backend_ov_async_->get_nireq(), items);
-            backend_ov_async_->predict_async(items);
+        // Sized up front: the warm-up keeps pointers into qitems_
+        if (qitems_.size() < backend_ov_async_->get_nireq()) {
+            qitems_.resize(backend_ov_async_->get_nireq());
         }
-        ov_qsl_->UnloadSamplesFromRam(samples);
+        backend_ov_async_->set_warmup(true);
+        std::cout << " == Starting Warmup ==\n";
+        auto fill = [this](const std::vector<mlperf::QuerySampleIndex>& samples,
+                           const std::vector<mlperf::ResponseId>& response_ids,
+                           size_t batch, size_t shape) {
+            Item* item = &qitems_[batch];
+            GetWarmupBatch(samples, response_ids, batch, shape, item);
+            return item;
+        };
+        WarmUpAllRequests(properties, backend_ov_async_.get(), fill);
+        backend_ov_async_->set_warmup(false);
         backend_ov_async_->reset();
         std::cout << " == Warmup Completed ==\n";
     }
 
     void IssueQuery(const std::vector<mlperf::QuerySample>& samples) override {
-        std::vector<mlperf::QuerySampleResponse> responses;
-        std::vector<mlperf::QuerySampleIndex> sample_idxs;
-        std::vector<mlperf::ResponseId> response_ids;
+        ALLOCATION_SCOPE();
+        CopyQuerySamples(samples, samples.size());
+
+        if (seq_buckets_.enabled()) {
+            RunBucketBatches();
+            return;
+        }
+
+        if (ov_properties_.prebind_inputs) {
+            RunStagedBatches(samples.size());
+            return;
+        }
 
-        for (size_t i = 0; i < samples.size(); ++i) {
-            sample_idxs.push_back(samples[i].index);
-            response_ids.push_back(samples[i].id);
+        // qitems_ keeps its Items across queries; only the first num_batches are refilled
+        size_t num_batches = samples.size() / batch_size_;
+        ov_qsl_->GetSamplesBatchedMultistream(sample_idxs_, response_ids_, batch_size_, num_batches, qitems_);
+        size_t tail = samples.size() - num_batches * batch_size_;
+        if (tail > 0) {
+            if (qitems_.size() <= num_batches) {
+                qitems_.resize(num_batches + 1);
+            }
+            GetTailBatch(sample_idxs_, response_ids_, num_batches * batch_size_, tail, &qitems_[num_batches]);
+            ++num_batches;
         }
 
-        int num_batches = samples.size() / batch_size_;
-        ov_qsl_->GetSamplesBatchedMultistream(sample_idxs, response_ids, batch_size_, num_batches, qitems_);
-        RunOneItem(response_ids);
+        RunOneItem(num_batches);
     }
 private:
-    void RunOneItem(std::vector<mlperf::ResponseId> response_id) {
-        backend_ov_async_->predict_async(qitems_);
-
-        std::vector<mlperf::QuerySampleResponse> responses =
-            backend_ov_async_->get_query_sample_responses();
+    // Samples are reported to loadgen from each request's completion callback
+    void RunOneItem(size_t num_batches) {
+        backend_ov_async_->predict_async(qitems_, num_batches);
+        backend_ov_async_->reset();
+    }
 
-        mlperf::QuerySamplesComplete(responses.data(), responses.size());
+    // With pre-bound inputs each batch is gathered into the request it runs on as soon as
+    // that request is idle, instead of being copied there from a view of the QSL
+    void RunStagedBatches(size_t num_samples) {
+        size_t num_batches = (num_samples + batch_size_ - 1) / batch_size_;
+        // Sized before the first submit: in-flight requests keep pointers into qitems_
+        if (qitems_.size() < num_batches) {
+            qitems_.resize(num_batches);
+        }
+        for (size_t i = 0; i < num_batches; ++i) {
+            size_t begin = i * batch_size_;
+            size_t count = std::min<size_t>(batch_size_, num_samples - begin);
+            backend_ov_async_->submit_async(qitems_[i], [&](Item* item) {
+                GetTailBatch(sample_idxs_, response_ids_, begin, count, item);
+            });
+        }
+        backend_ov_async_->wait_all();
         backend_ov_async_->reset();
-        qitems_.clear();
+    }
+
+    // Batches the query's samples by length bucket; each bucket's last batch is padded
+    void RunBucketBatches() {
+        BucketQuerySamples();
+        size_t num_batches = 0;
+        ForEachBucketBatch([this, &num_batches](size_t bucket, size_t begin, size_t count) {
+            if (qitems_.size() <= num_batches) {
+                qitems_.resize(num_batches + 1);
+            }
+            GetBucketBatch(sample_idxs_, response_ids_, bucket, begin, count, &qitems_[num_batches++]);
+        });
+        RunOneItem(num_batches);
     }
 };
 
@@ -2,7 +2,25 @@
 
 #include "sut_base.h"
 
-class SUTOffline : public SUTBase {
+template <typename Workload>
+class SUTOffline : public SUTBase<Workload> {
+protected:
+    using SUTBase<Workload>::settings_;
+    using SUTBase<Workload>::ov_qsl_;
+    using SUTBase<Workload>::batch_size_;
+    using SUTBase<Workload>::backend_ov_async_;
+    using SUTBase<Workload>::sample_idxs_;
+    using SUTBase<Workload>::response_ids_;
+    using SUTBase<Workload>::CopyQuerySamples;
+    using SUTBase<Workload>::seq_buckets_;
+    using SUTBase<Workload>::BucketQuerySamples;
+    using SUTBase<Workload>::ForEachBucketBatch;
+    using SUTBase<Workload>::GetBucketBatch;
+    using SUTBase<Workload>::WarmUpBuckets;
+    using SUTBase<Workload>::WarmUpAllRequests;
+    using SUTBase<Workload>::GetWarmupBatch;
+    using SUTBase<Workload>::GetTailBatch;
+
  public:
   SUTOffline(mlperf::TestSettings settings,
              QSLBase* ov_qsl,
@@ -10,66 +28,171 @@ class SUTOffline : public SUTBase {
              int batch_size,
              std::string dataset,
              std::string workload,
-             std::vector<std::string> input_blob_names,
-             std::vector<std::string> output_blob_names,
-             std::string input_model,
-             PPFunction post_processor)
-      : SUTBase(settings, ov_qsl, ov_properties, batch_size, dataset, workload, input_blob_names,
-                output_blob_names, input_model, post_processor, true) {}
+             std::string input_model)
+      : SUTBase<Workload>(settings, ov_qsl, InstanceProperties(ov_properties, 0), batch_size, dataset,
+                workload, input_model, true),
+        extra_instances_(CreateExtraInstances(settings, ov_properties, batch_size, input_model)),
+        // One Item per in-flight request plus the batch being assembled
+        item_pool_(TotalRequests() + 1, Workload::num_inputs, batch_size),
+        shard_batches_(num_instances()) {}
 
     const std::string& Name() override {
         static const std::string name("OpenVINO Offline SUT");
         return name;
     }
 
-    void WarmUp(size_t nwarmup_iters) override {
-        std::vector<mlperf::QuerySampleIndex> samples;
-        std::vector<mlperf::ResponseId> query_ids;
+    void WarmUp(const WarmupProperties& properties) override {
+        if (seq_buckets_.enabled()) {
+            WarmUpBuckets(properties.min_rounds);
+        }
 
-        for (size_t i = 0; i < batch_size_ * backend_ov_async_->get_nireq(); ++i) {
-            samples.push_back(0);
-            query_ids.push_back(1);
+        auto fill = [this](const std::vector<mlperf::QuerySampleIndex>& samples,
+                           const std::vector<mlperf::ResponseId>& response_ids,
+                           size_t batch, size_t shape) {
+            Item* item = &item_pool_.acquire();
+            GetWarmupBatch(samples, response_ids, batch, shape, item);
+            return item;
+        };
+        for (size_t i = 0; i < num_instances(); ++i) {
+            instance(i)->set_warmup(true);
+            WarmUpAllRequests(properties, instance(i), fill);
+            instance(i)->set_warmup(false);
+            instance(i)->reset();
         }
+    }
 
-        ov_qsl_->LoadSamplesToRam(samples);
+    void IssueQuery(const std::vector<mlperf::QuerySample>& samples) override {
+        ALLOCATION_SCOPE();
+        CopyQuerySamples(samples, samples.size());
 
-        for (size_t i = 0; i < nwarmup_iters; ++i) {
-            std::vector<mlperf::ResponseId> results_ids;
-            std::vector<mlperf::QuerySampleIndex> sample_idxs;
+        if (seq_buckets_.enabled()) {
+            RunBucketBatches();
+        } else {
+            size_t num_batches = (samples.size() + batch_size_ - 1) / batch_size_;
+            if (extra_instances_.empty()) {
+                RunBatches(sample_idxs_, response_ids_, num_batches);
+            } else {
+                RunShardedBatches(sample_idxs_, response_ids_, num_batches);
+            }
+        }
+        for (size_t i = 0; i < num_instances(); ++i) {
+            instance(i)->reset();
+        }
+    }
+private:
+    // Properties of backend instance i: its cores, when there are several instances
+    static OVBackendProperties InstanceProperties(OVBackendProperties ov_properties, size_t i) {
+        if (i < ov_properties.instance_cores.size()) {
+            ov_properties.cores = ov_properties.instance_cores[i];
+        }
+        return ov_properties;
+    }
 
-            std::vector<Item> items;
-            ov_qsl_->GetSamplesBatched(samples, query_ids, batch_size_, backend_ov_async_->get_nireq(), items);
-            backend_ov_async_->predict_async(items);
+    // Instances 1..N-1; instance 0 is SUTBase's backend
+    static std::vector<std::unique_ptr<OVBackendAsync<Workload>>> CreateExtraInstances(
+            const mlperf::TestSettings& settings, const OVBackendProperties& ov_properties,
+            int batch_size, const std::string& input_model) {
+        std::vector<std::unique_ptr<OVBackendAsync<Workload>>> instances;
+        for (size_t i = 1; i < ov_properties.instance_cores.size(); ++i) {
+            std::cout << "    [INFO] Loading backend instance " << i << std::endl;
+            instances.emplace_back(new OVBackendAsync<Workload>(
+                    settings, InstanceProperties(ov_properties, i), batch_size, input_model));
+            instances.back()->load();
         }
-        ov_qsl_->UnloadSamplesFromRam(samples);
+        return instances;
+    }
 
-        backend_ov_async_->reset();
+    size_t num_instances() const {
+        return extra_instances_.size() + 1;
     }
 
-    void IssueQuery(const std::vector<mlperf::QuerySample>& samples) override {
-        std::vector<mlperf::QuerySampleResponse> responses;
-        std::vector<mlperf::QuerySampleIndex> sample_idxs;
-        std::vector<mlperf::ResponseId> response_ids;
+    OVBackendAsync<Workload>* instance(size_t i) {
+        return i == 0 ? backend_ov_async_.get() : extra_instances_[i - 1].get();
+    }
 
-        for (size_t i = 0; i < samples.size(); ++i) {
-            sample_idxs.push_back(samples[i].index);
-            response_ids.push_back(samples[i].id);
+    size_t TotalRequests() {
+        size_t nireq = 0;
+        for (size_t i = 0; i < num_instances(); ++i) {
+            nireq += instance(i)->get_nireq();
         }
+        return nireq;
+    }
 
-        int num_batches = samples.size() / batch_size_;
-        ov_qsl_->GetSamplesBatched(sample_idxs, response_ids, batch_size_, num_batches, qitems_);
+    // Batch i of a query; the last one may be partial
+    void GetBatch(const std::vector<mlperf::QuerySampleIndex>& sample_idxs,
+                  const std::vector<mlperf::ResponseId>& response_ids, size_t i, Item* item) {
+        size_t begin = i * batch_size_;
+        if (begin + batch_size_ <= sample_idxs.size()) {
+            ov_qsl_->GetSamplesBatch(sample_idxs, response_ids, batch_size_, i, item);
+        } else {
+            GetTailBatch(sample_idxs, response_ids, begin, sample_idxs.size() - begin, item);
+        }
+    }
 
-        RunOneItem(response_ids);
+    // Producer side of the Offline pipeline: each batch is assembled only once an Item and
+    // an idle request are free and is started right away, so inference begins with the
+    // first batch. Samples are reported to loadgen from each request's completion callback.
+    void RunBatches(const std::vector<mlperf::QuerySampleIndex>& sample_idxs,
+                    const std::vector<mlperf::ResponseId>& response_ids, size_t num_batches) {
+        for (size_t i = 0; i < num_batches; ++i) {
+            backend_ov_async_->submit_async(item_pool_.acquire(), [&](Item* item) {
+                GetBatch(sample_idxs, response_ids, i, item);
+            });
+        }
+        backend_ov_async_->wait_all();
     }
-private:
-    void RunOneItem(std::vector<mlperf::ResponseId> response_id) {
-        backend_ov_async_->predict_async(qitems_);
 
-        std::vector<mlperf::QuerySampleResponse> responses =
-            backend_ov_async_->get_query_sample_responses();
+    // Multi-instance pipeline: every batch runs on the instance whose NUMA node holds its
+    // samples. Batches are interleaved across instances, so waiting for an idle request of
+    // one instance leaves the others with their queued requests.
+    void RunShardedBatches(const std::vector<mlperf::QuerySampleIndex>& sample_idxs,
+                           const std::vector<mlperf::ResponseId>& response_ids, size_t num_batches) {
+        for (auto& batches : shard_batches_) {
+            batches.clear();
+        }
+        // Once a query wraps past a performance sample count that is not a multiple of the
+        // batch size, batches start off the shard boundaries; each goes to the shard holding
+        // its middle sample, which has most of the batch
+        size_t perf_count = ov_qsl_->PerformanceSampleCount();
+        for (size_t i = 0; i < num_batches; ++i) {
+            size_t position = (i * batch_size_ + batch_size_ / 2) % perf_count;
+            shard_batches_[ov_qsl_->GetSampleShard(position)].push_back(i);
+        }
 
-        mlperf::QuerySamplesComplete(responses.data(), responses.size());
-        backend_ov_async_->reset();
-        qitems_.clear();
+        size_t submitted = 0;
+        for (size_t round = 0; submitted < num_batches; ++round) {
+            for (size_t s = 0; s < shard_batches_.size(); ++s) {
+                if (round >= shard_batches_[s].size()) {
+                    continue;
+                }
+                instance(s)->submit_async(item_pool_.acquire(), [&](Item* item) {
+                    GetBatch(sample_idxs, response_ids, shard_batches_[s][round], item);
+                });
+                ++submitted;
+            }
+        }
+        for (size_t s = 0; s < num_instances(); ++s) {
+            instance(s)->wait_all();
+        }
+    }
+
+    // Same pipeline over length-sorted samples; each bucket's last batch is padded.
+    // With several instances the batches are dealt out round-robin.
+    void RunBucketBatches() {
+        BucketQuerySamples();
+        size_t next_instance = 0;
+        ForEachBucketBatch([this, &next_instance](size_t bucket, size_t begin, size_t count) {
+            Item& item = item_pool_.acquire();
+            GetBucketBatch(sample_idxs_, response_ids_, bucket, begin, count, &item);
+            instance(next_instance++ % num_instances())->submit_async(item);
+        });
+        for (size_t i = 0; i < num_instances(); ++i) {
+            instance(i)->wait_all();
+        }
     }
-};
\ No newline at end of file
+
+    std::vector<std::unique_ptr<OVBackendAsync<Workload>>> extra_instances_;
+    ItemPool item_pool_;
+    // Batch indices per NUMA shard, reused across queries
+    std::vector<std::vector<size_t>> shard_batches_;
+};
@@ -1,8 +1,38 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "blocking_queue.h"
+#include "elastic_requests.h"
 #include "sut_base.h"
 
-class SUTServer : public SUTBase {
+struct ServerProperties {
+    // Number of threads binding ingress queries to idle infer requests
+    unsigned dispatch_threads = 1;
+    // Share of server_target_latency_ns a query may wait for its batch to fill up
+    double batching_latency_fraction = 0.1;
+    // Time between two resizes of an elastic request pool (OVBackendProperties::nireq_max)
+    unsigned elastic_interval_ms = 100;
+};
+
+template <typename Workload>
+class SUTServer : public SUTBase<Workload> {
+protected:
+    using SUTBase<Workload>::settings_;
+    using SUTBase<Workload>::ov_qsl_;
+    using SUTBase<Workload>::batch_size_;
+    using SUTBase<Workload>::backend_ov_async_;
+    using SUTBase<Workload>::seq_buckets_;
+    using SUTBase<Workload>::GetBucketBatch;
+    using SUTBase<Workload>::WarmUpBuckets;
+    using SUTBase<Workload>::WarmUpAllRequests;
+    using SUTBase<Workload>::GetWarmupBatch;
+    using SUTBase<Workload>::ov_properties_;
+    using RequestsQueueServer = typename OVBackendBase<Workload>::RequestsQueueServer;
+
 public:
     SUTServer(mlperf::TestSettings settings,
             QSLBase* ov_qsl,
@@ -10,64 +40,182 @@ public:
             int batch_size,
             std::string dataset,
             std::string workload,
-            std::vector<std::string> input_blob_names,
-            std::vector<std::string> output_blob_names, std::string input_model,
-            PPFunction post_processor)
+            std::string input_model,
+            ServerProperties server_properties = ServerProperties())
         : online_bs_(),
-        SUTBase(settings, ov_qsl, ov_properties, batch_size, dataset, workload, input_blob_names,
-                output_blob_names, input_model, post_processor, true) {}
+        SUTBase<Workload>(settings, ov_qsl, ov_properties, batch_size, dataset, workload,
+                input_model, true),
+        server_properties_(server_properties),
+        // Every in-flight request holds one Item and every dispatcher may hold one more
+        item_pool_(backend_ov_async_->get_nireq() + std::max(1u, server_properties.dispatch_threads),
+                   Workload::num_inputs, batch_size) {
+        batching_budget_ = std::chrono::nanoseconds(static_cast<int64_t>(
+                settings_.server_target_latency_ns * server_properties_.batching_latency_fraction));
+        if (batch_size_ > 1) {
+            std::cout << "    [INFO] Server dynamic batching: up to " << batch_size_ << " samples within "
+                      << batching_budget_.count() / 1000 << " us" << std::endl;
+        }
+
+        if (backend_ov_async_->elastic_requests()) {
+            ElasticRequestsProperties elastic_properties;
+            elastic_properties.min_requests = ov_properties_.nireq_min;
+            elastic_properties.max_requests = backend_ov_async_->get_nireq();
+            elastic_properties.interval_ms = server_properties_.elastic_interval_ms;
+            elastic_.reset(new ElasticRequests<RequestsQueueServer>(
+                    backend_ov_async_->server_requests(), elastic_properties, backend_ov_async_->initial_nireq()));
+        }
+
+        unsigned num_dispatchers = std::max(1u, server_properties_.dispatch_threads);
+        for (unsigned i = 0; i < num_dispatchers; ++i) {
+            dispatchers_.emplace_back(&SUTServer::DispatchLoop, this);
+        }
+    }
+
+    ~SUTServer() {
+        elastic_.reset();
+        ingress_.close();
+        for (auto& dispatcher : dispatchers_) {
+            dispatcher.join();
+        }
+    }
 
     const std::string& Name() override {
         static const std::string name("OpenVINO Server SUT");
         return name;
     }
 
-    void WarmUp(size_t nwarmup_iters) override {
-        backend_ov_async_->set_server_warmup(true);
-
-        std::vector<mlperf::QuerySampleIndex> samples;
-        std::vector<mlperf::ResponseId> response_ids;
-
-        for (size_t i = 0; i < batch_size_; ++i) {
-            samples.push_back(0);
-            response_ids.push_back(1);
+    void WarmUp(const WarmupProperties& properties) override {
+        if (seq_buckets_.enabled()) {
+            WarmUpBuckets(properties.min_rounds);
         }
+        backend_ov_async_->set_server_warmup(true);
 
-        ov_qsl_->LoadSamplesToRam(samples);
-
-        std::vector<Blob::Ptr> data;
-        Item item;
+        // Without buckets the batches go through BuildItem like the dispatched ones
+        std::vector<mlperf::QuerySampleIndex> batch_idxs;
+        std::vector<mlperf::ResponseId> batch_ids;
+        auto fill = [&](const std::vector<mlperf::QuerySampleIndex>& samples,
+                        const std::vector<mlperf::ResponseId>& response_ids,
+                        size_t batch, size_t shape) {
+            Item* item = &item_pool_.acquire();
+            if (seq_buckets_.enabled()) {
+                GetWarmupBatch(samples, response_ids, batch, shape, item);
+            } else {
+                batch_idxs.assign(samples.begin() + batch * batch_size_, samples.begin() + (batch + 1) * batch_size_);
+                batch_ids.assign(response_ids.begin() + batch * batch_size_,
+                                 response_ids.begin() + (batch + 1) * batch_size_);
+                BuildItem(batch_idxs, batch_ids, item);
+            }
+            return item;
+        };
+        WarmUpAllRequests(properties, backend_ov_async_.get(), fill);
 
-        ov_qsl_->GetSample(samples, response_ids, 1, &item);
+        backend_ov_async_->reset();
+        seq_buckets_.reset_counts();
+    }
 
-        for (size_t i = 0; i < nwarmup_iters; ++i) {
-            backend_ov_async_->predict_async_server(item);
+    // Only enqueues the samples; binding to infer requests happens on the dispatch threads
+    // so loadgen's issue thread never waits for an idle request.
+    void IssueQuery(const std::vector<mlperf::QuerySample>& samples) override {
+        ALLOCATION_SCOPE();
+        alloc_counter::count_query();
+        if (dispatch_failed_.load(std::memory_order_acquire)) {
+            std::rethrow_exception(dispatch_exception_);
         }
+        auto arrival = std::chrono::steady_clock::now();
+        for (const auto& sample : samples) {
+            ingress_.push(IngressSample{sample, arrival});
+        }
+    }
 
-        ov_qsl_->UnloadSamplesFromRam(samples);
+    void Report() override {
+        SUTBase<Workload>::Report();
+        if (elastic_) {
+            elastic_->stop();
+            elastic_->report();
+        }
+    }
 
-        backend_ov_async_->reset();
+ private:
+    struct IngressSample {
+        mlperf::QuerySample sample;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    // Pads partial batches inside the QSL so the statically batched model can run them.
+    // With sequence buckets the batch runs at the bucket of its longest sample.
+    void BuildItem(const std::vector<mlperf::QuerySampleIndex>& sample_idxs,
+                   const std::vector<mlperf::ResponseId>& response_ids, Item* item) {
+        if (seq_buckets_.enabled()) {
+            size_t max_len = 0;
+            for (auto sample : sample_idxs) {
+                max_len = std::max(max_len, ov_qsl_->GetSampleLength(sample));
+            }
+            GetBucketBatch(sample_idxs, response_ids, seq_buckets_.bucket_of(max_len), 0, sample_idxs.size(), item);
+        } else if (batch_size_ == 1) {
+            ov_qsl_->GetSample(sample_idxs, response_ids, 1, item);
+        } else {
+            ov_qsl_->GetSamplesBatchedServer(sample_idxs, response_ids, batch_size_, item);
+        }
     }
 
-    void IssueQuery(const std::vector<mlperf::QuerySample>& samples) override {
-        std::vector<mlperf::QuerySampleResponse> responses;
+    // A batch is submitted when it is full or when its oldest query has used up the batching budget
+    void DispatchLoop() {
         std::vector<mlperf::QuerySampleIndex> sample_idxs;
         std::vector<mlperf::ResponseId> response_ids;
-
-        for (size_t i = 0; i < samples.size(); ++i) {
-            sample_idxs.push_back(samples[i].index);
-            response_ids.push_back(samples[i].id);
+        sample_idxs.reserve(batch_size_);
+        response_ids.reserve(batch_size_);
+        ALLOCATION_SCOPE();
+        try {
+            IngressSample next;
+            while (ingress_.pop(next)) {
+                // Warm-up ran on every request and never goes through ingress_; the pool
+                // starts resizing with the first query sample
+                if (elastic_) {
+                    std::call_once(elastic_started_, [this] {
+                        ALLOCATION_SCOPE_PAUSE();
+                        elastic_->start();
+                    });
+                }
+                sample_idxs.clear();
+                response_ids.clear();
+                sample_idxs.push_back(next.sample.index);
+                response_ids.push_back(next.sample.id);
+
+                auto deadline = next.arrival + batching_budget_;
+                while (sample_idxs.size() < (size_t) batch_size_ && ingress_.pop_until(next, deadline)) {
+                    sample_idxs.push_back(next.sample.index);
+                    response_ids.push_back(next.sample.id);
+                }
+
+                Submit(sample_idxs, response_ids);
+            }
+        } catch (...) {
+            dispatch_exception_ = std::current_exception();
+            dispatch_failed_.store(true, std::memory_order_release);
         }
-
-        Item item;
-        ov_qsl_->GetSample(sample_idxs, response_ids, batch_size_, &item);
-        RunOneItem(response_ids, item);
     }
 
- private:
-    void RunOneItem(std::vector<mlperf::ResponseId> response_id, Item item) {
-        backend_ov_async_->predict_async_server(item);
+    // With pre-bound inputs the idle request is taken first so the QSL copies the batch
+    // straight into its input tensors
+    void Submit(const std::vector<mlperf::QuerySampleIndex>& sample_idxs,
+                const std::vector<mlperf::ResponseId>& response_ids) {
+        // Returned to the pool by the request's completion callback
+        Item& item = item_pool_.acquire();
+        auto request = backend_ov_async_->get_idle_server_request();
+        request->stage_inputs(item);
+        BuildItem(sample_idxs, response_ids, &item);
+        backend_ov_async_->predict_async_server(request, item);
     }
     int qid = 0;
     size_t online_bs_;
+
+    ServerProperties server_properties_;
+    ItemPool item_pool_;
+    std::chrono::nanoseconds batching_budget_;
+    BlockingQueue<IngressSample> ingress_;
+    std::vector<std::thread> dispatchers_;
+    std::atomic<bool> dispatch_failed_{false};
+    std::exception_ptr dispatch_exception_ = nullptr;
+    std::unique_ptr<ElasticRequests<RequestsQueueServer>> elastic_;
+    std::once_flag elastic_started_;
 };
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <thread>
+
+#include "post_processing_pool.h"
+#include "sut_base.h"
+
+struct SingleStreamProperties {
+    // Cores the issuing thread is pinned to, e.g. "0" or "0-1"; empty keeps the OS placement
+    std::string cores = "";
+    // Spin on the request status instead of blocking in infer()
+    bool busy_poll = false;
+};
+
+/// @brief Latency-oriented SingleStream SUT.
+///
+/// Runs one synchronous request with its input tensors bound once at start-up:
+/// each query copies its sample into the bound tensors, runs on the loadgen issue
+/// thread (optionally pinned and busy-polling) and reports from the preallocated
+/// response arena.
+template <typename Workload>
+class SUTSingleStream : public SUTBase<Workload> {
+protected:
+    using SUTBase<Workload>::ov_qsl_;
+    using SUTBase<Workload>::batch_size_;
+    using SUTBase<Workload>::backend_ov_;
+    using SUTBase<Workload>::qitem_;
+    using SUTBase<Workload>::sample_idxs_;
+    using SUTBase<Workload>::response_ids_;
+    using SUTBase<Workload>::arena_;
+    using SUTBase<Workload>::CopyQuerySamples;
+    using SUTBase<Workload>::WarmUpSingleRequest;
+
+public:
+    SUTSingleStream(mlperf::TestSettings settings,
+                    QSLBase* ov_qsl,
+                    OVBackendProperties ov_properties,
+                    int batch_size,
+                    std::string dataset,
+                    std::string workload,
+                    std::string input_model,
+                    SingleStreamProperties ss_properties = SingleStreamProperties())
+        : SUTBase<Workload>(settings, ov_qsl, ov_properties, batch_size, dataset, workload,
+                input_model, false),
+        ss_properties_(ss_properties),
+        cores_(parse_core_list(ss_properties.cores)) {
+        backend_ov_->bind_inputs();
+        backend_ov_->stage_inputs(qitem_);
+        if (!cores_.empty() || ss_properties_.busy_poll) {
+            std::cout << "    [INFO] SingleStream issue thread: "
+                      << (cores_.empty() ? "not pinned" : "pinned to cores " + ss_properties_.cores)
+                      << (ss_properties_.busy_poll ? ", busy-polling" : "") << std::endl;
+        }
+    }
+
+    const std::string& Name() override {
+        static const std::string name("OpenVINO SingleStream SUT");
+        return name;
+    }
+
+    void WarmUp(const WarmupProperties& properties) override {
+        ResponseArena arena;
+        backend_ov_->init_response_arena(arena);
+        WarmUpSingleRequest(properties, [&](Item& item) {
+            backend_ov_->predict_bound(item, arena, ss_properties_.busy_poll);
+        });
+    }
+
+    void IssueQuery(const std::vector<mlperf::QuerySample>& samples) override {
+        ALLOCATION_SCOPE();
+        PinIssueThread();
+        CopyQuerySamples(samples, 1);
+        ov_qsl_->GetSample(sample_idxs_, response_ids_, 1, &qitem_);
+
+        backend_ov_->predict_bound(qitem_, arena_, ss_properties_.busy_poll);
+        ALLOCATION_SCOPE_PAUSE();
+        mlperf::QuerySamplesComplete(arena_.responses(), arena_.num_responses());
+    }
+
+private:
+    // Loadgen owns the issue thread, so it is pinned on its first query
+    void PinIssueThread() {
+        if (cores_.empty() || pinned_thread_ == std::this_thread::get_id()) {
+            return;
+        }
+        pin_current_thread(cores_);
+        pinned_thread_ = std::this_thread::get_id();
+    }
+
+    SingleStreamProperties ss_properties_;
+    std::vector<int> cores_;
+    std::thread::id pinned_thread_;
+};
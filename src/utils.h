@@ -8,11 +8,41 @@
 
 #include <string>
 #include <algorithm>
+#include <fstream>
+#include <sstream>
 #include <thread>
 #include <utility>
 #include <vector>
 #include <map>
 
+/// @brief Resident memory of this process in KiB, from /proc/self/status; zeros where unavailable.
+struct ResidentMemory {
+    size_t total_kb = 0;
+    // Pages mapped from files, e.g. memory-mapped weights that other processes share
+    size_t file_kb = 0;
+    size_t anon_kb = 0;
+
+    static ResidentMemory current() {
+        ResidentMemory memory;
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            std::istringstream fields(line);
+            std::string key;
+            size_t value = 0;
+            fields >> key >> value;
+            if (key == "VmRSS:") {
+                memory.total_kb = value;
+            } else if (key == "RssFile:") {
+                memory.file_kb = value;
+            } else if (key == "RssAnon:") {
+                memory.anon_kb = value;
+            }
+        }
+        return memory;
+    }
+};
+
 std::vector<std::string> split(const std::string &s, char delim) {
     std::vector<std::string> result;
     std::stringstream ss(s);
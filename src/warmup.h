@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct WarmupProperties {
+    // Rounds always run before convergence is checked
+    size_t min_rounds = 10;
+    // Hard stop when round latency does not settle
+    size_t max_rounds = 100;
+    // Rounds in the rolling window whose latency spread is checked
+    size_t window = 5;
+    // Converged once the window's coefficient of variation is at most this
+    double max_cv = 0.05;
+};
+
+/// @brief Decides when warm-up is done from the latency of its rounds.
+///
+/// A round exercises every infer request (and every batch shape) once. Warm-up
+/// stops when the coefficient of variation of the last `window` round latencies
+/// drops to `max_cv`, so JIT, first-touch and cache effects are paid before the
+/// timed run rather than after a fixed number of iterations.
+class WarmupMonitor final {
+public:
+    explicit WarmupMonitor(const WarmupProperties& properties) :
+            properties_(properties),
+            start_(std::chrono::steady_clock::now()) {}
+
+    /// Records one round and returns true once warm-up may stop.
+    bool add_round(double ms) {
+        round_ms_.push_back(ms);
+        size_t rounds = round_ms_.size();
+        if (rounds < std::max(properties_.min_rounds, properties_.window)) {
+            return rounds >= properties_.max_rounds;
+        }
+
+        auto first = round_ms_.end() - properties_.window;
+        double mean = 0;
+        for (auto it = first; it != round_ms_.end(); ++it) {
+            mean += *it;
+        }
+        mean /= properties_.window;
+        double variance = 0;
+        for (auto it = first; it != round_ms_.end(); ++it) {
+            variance += (*it - mean) * (*it - mean);
+        }
+        cv_ = mean > 0 ? std::sqrt(variance / properties_.window) / mean : 0;
+        converged_ = cv_ <= properties_.max_cv;
+        return converged_ || rounds >= properties_.max_rounds;
+    }
+
+    static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report() const {
+        std::cout << "    [INFO] Warm-up took " << std::fixed << std::setprecision(1) << elapsed_ms(start_)
+                  << " ms: " << round_ms_.size() << " rounds, last round " << std::setprecision(2)
+                  << (round_ms_.empty() ? 0.0 : round_ms_.back()) << " ms, latency CV "
+                  << 100 * cv_ << "% over " << properties_.window << " rounds"
+                  << (converged_ ? "" : " (not converged, stopped at --warmup_max_iters)") << std::endl;
+    }
+
+private:
+    WarmupProperties properties_;
+    std::chrono::steady_clock::time_point start_;
+    std::vector<double> round_ms_;
+    double cv_ = 0;
+    bool converged_ = false;
+};
@@ -1,8 +1,16 @@
 #pragma once
 
+#include<array>
 #include<string>
 #include<vector>
 #include<map>
+#include<memory>
+
+#include <openvino/openvino.hpp>
+
+#include "item_ov.h"
+#include "response_arena.h"
+#include "postprocess/post_processors.h"
 
 namespace mlperf_ov {
 	enum class WorkloadName {
@@ -17,53 +25,128 @@ namespace mlperf_ov {
         SQuAD_v1_1,
     };
 
-	class WorkloadBase {
-	public:
-		WorkloadBase(const std::vector<std::string>& input_names,
-                     const std::vector<std::string>& output_names,
-                     const DatasetName& dataset_name,
-                     const WorkloadName& workload_name) :
-            input_names_(input_names),
-            output_names_(output_names),
-            dataset_name_(dataset_name),
-            workload_name_(workload_name) {}
-        WorkloadName get_workload_name() { return workload_name_; };
-        DatasetName get_dataset_name() { return dataset_name_; };
-        std::vector<std::string> get_input_names() { return input_names_; };
-        std::vector<std::string> get_output_names() { return output_names_; };
-    protected:
-		std::vector<std::string> input_names_, output_names_;
-        WorkloadName workload_name_;
-		DatasetName dataset_name_;
-	};
-;
-	class ResNet50 : public WorkloadBase {
+    template <size_t N>
+    std::vector<std::string> to_names(const char* const (&names)[N]) {
+        return std::vector<std::string>(names, names + N);
+    }
+
+    // Output ports a post-processor reads, resolved once per compiled model so completions
+    // do no tensor name lookups. With zero-copy outputs only `response` is set.
+    template <size_t N>
+    struct OutputPorts {
+        std::array<ov::Output<const ov::Node>, N> outputs;
+        ov::Output<const ov::Node> response;
+    };
+
+    template <typename Workload>
+    OutputPorts<Workload::num_outputs> resolve_output_ports(const ov::CompiledModel& model, bool zero_copy_outputs) {
+        OutputPorts<Workload::num_outputs> ports;
+        if (zero_copy_outputs) {
+            ports.response = model.output(Workload::response_output_name);
+        } else {
+            for (size_t j = 0; j < Workload::num_outputs; ++j) {
+                ports.outputs[j] = model.output(Workload::output_names[j]);
+            }
+        }
+        return ports;
+    }
+
+    // Workload classes are compile-time traits: the backend, request queues and SUTs are
+    // templated on them, so tensor names, input precision and post-processing are
+    // resolved at compile time and inlined into the completion path.
+	class ResNet50 {
 	public:
-		ResNet50() : WorkloadBase({ "input_tensor:0" },
-                                  { "softmax_tensor:0" },
-                                  DatasetName::ImageNet2012,
-                                  WorkloadName::ResNet50) {}
-		~ResNet50(){};
-		void postprocess(){};
+        static constexpr WorkloadName workload_name = WorkloadName::ResNet50;
+        static constexpr DatasetName dataset_name = DatasetName::ImageNet2012;
+        static constexpr size_t num_inputs = 1;
+        static constexpr size_t num_outputs = 1;
+        static constexpr const char* input_names[num_inputs] = { "input_tensor:0" };
+        static constexpr const char* output_names[num_outputs] = { "softmax_tensor:0" };
+        // Responses are class indices computed from the scores, so they cannot be read in place
+        static constexpr const char* response_output_name = nullptr;
+
+        static ov::element::Type input_element_type() { return ov::element::u8; }
+
+        // One class index per sample
+        static size_t max_response_size(const std::vector<ov::Shape>& output_shapes) {
+            return output_shapes.at(0).at(0);
+        }
+
+		static void postprocess(const Item &qitem, ov::InferRequest &req, const OutputPorts<num_outputs> &ports,
+                                ResponseArena &arena, unsigned batch_size) {
+            Processors::postprocess_classification(qitem, req, arena, batch_size, ports.outputs[0]);
+        }
 	};
-	class RetinaNet : public WorkloadBase {
+    constexpr WorkloadName ResNet50::workload_name;
+    constexpr DatasetName ResNet50::dataset_name;
+    constexpr const char* ResNet50::input_names[];
+    constexpr const char* ResNet50::output_names[];
+    constexpr const char* ResNet50::response_output_name;
+
+	class RetinaNet {
     public:
-        RetinaNet() : WorkloadBase({ "images" },
-                                   { "boxes", "scores", "labels" },
-                              DatasetName::OpenImages_v6,
-                              WorkloadName::RetinaNet) {}
-        ~RetinaNet(){};
-        void postprocess(){};
+        static constexpr WorkloadName workload_name = WorkloadName::RetinaNet;
+        static constexpr DatasetName dataset_name = DatasetName::OpenImages_v6;
+        static constexpr size_t num_inputs = 1;
+        static constexpr size_t num_outputs = 3;
+        static constexpr const char* input_names[num_inputs] = { "images" };
+        static constexpr const char* output_names[num_outputs] = { "boxes", "scores", "labels" };
+        // Responses keep only the detections above the score threshold
+        static constexpr const char* response_output_name = nullptr;
+
+        static ov::element::Type input_element_type() { return ov::element::u8; }
+
+        // [sample, ymin, xmin, ymax, xmax, score, label] per kept prediction
+        static size_t max_response_size(const std::vector<ov::Shape>& output_shapes) {
+            return 7 * output_shapes.at(1).at(0);
+        }
+
+        static void postprocess(const Item &qitem, ov::InferRequest &req, const OutputPorts<num_outputs> &ports,
+                                ResponseArena &arena, unsigned batch_size) {
+            Processors::postprocess_ssd_retinanet(qitem, req, arena, batch_size,
+                                                  ports.outputs[0], ports.outputs[1], ports.outputs[2]);
+        }
     };
-	class Bert : public WorkloadBase {
+    constexpr WorkloadName RetinaNet::workload_name;
+    constexpr DatasetName RetinaNet::dataset_name;
+    constexpr const char* RetinaNet::input_names[];
+    constexpr const char* RetinaNet::output_names[];
+    constexpr const char* RetinaNet::response_output_name;
+
+	class Bert {
     public:
-        Bert() : WorkloadBase({ "input_ids", "input_mask", "segment_ids" },
-                              { "output_start_logits", "output_end_logits" },
-                              DatasetName::SQuAD_v1_1,
-                              WorkloadName::Bert) {}
-        ~Bert(){};
-        void postprocess(){};
+        static constexpr WorkloadName workload_name = WorkloadName::Bert;
+        static constexpr DatasetName dataset_name = DatasetName::SQuAD_v1_1;
+        static constexpr size_t num_inputs = 3;
+        static constexpr size_t num_outputs = 2;
+        static constexpr const char* input_names[num_inputs] = { "input_ids", "input_mask", "segment_ids" };
+        static constexpr const char* output_names[num_outputs] = { "output_start_logits", "output_end_logits" };
+        // Zero-copy responses: both outputs interleaved in the graph, [start, end] per token
+        static constexpr const char* response_output_name = "output_logits";
+
+        static ov::element::Type input_element_type() { return ov::element::i32; }
+
+        // Interleaved start/end logits for every token
+        static size_t max_response_size(const std::vector<ov::Shape>& output_shapes) {
+            return 2 * ov::shape_size(output_shapes.at(0));
+        }
+
+        static void postprocess(const Item &qitem, ov::InferRequest &req, const OutputPorts<num_outputs> &ports,
+                                ResponseArena &arena, unsigned batch_size) {
+            if (arena.zero_copy()) {
+                Processors::postprocess_bert_zero_copy(qitem, req, arena, batch_size, ports.response);
+            } else {
+                // SQuAD features are padded to 384 tokens
+                Processors::postprocess_bert_common(qitem, req, arena, batch_size,
+                                                    ports.outputs[0], ports.outputs[1], 384);
+            }
+        }
     };
+    constexpr WorkloadName Bert::workload_name;
+    constexpr DatasetName Bert::dataset_name;
+    constexpr const char* Bert::input_names[];
+    constexpr const char* Bert::output_names[];
+    constexpr const char* Bert::response_output_name;
 }; // namespace mlperf_ov
 
 std::ostream& operator<<(std::ostream& os, const mlperf_ov::WorkloadName& wn) {